@@ -2,149 +2,216 @@
 #include <stdio.h>
 #include "pro.h"
 
-EdgeNode* Make_list_With_Dummy() {
-    // Creates a linked list with dummy head and tail nodes.
-    EdgeNode* dummy_head, * dummy_tail;
-    dummy_head = (EdgeNode*)malloc(sizeof(EdgeNode));
-    dummy_tail = (EdgeNode*)malloc(sizeof(EdgeNode));
-    if (dummy_head == NULL || dummy_tail == NULL)
-        exit(1); // Exit if memory allocation fails.
-
-    // Initialize dummy nodes.
-    dummy_head->e.neighbor = dummy_tail->e.neighbor = -1;
-    dummy_head->e.cost = dummy_tail->e.cost = 0;
-    dummy_head->next = dummy_tail;
-    dummy_tail->next = NULL;
-
-    return dummy_head; // Return the head of the linked list.
-}
-
-EdgeNode* Create_New_Node(int neighbor, int cost) {
-    // Creates a new node representing an edge.
-    EdgeNode* new_node;
-    new_node = (EdgeNode*)malloc(sizeof(EdgeNode));
-    if (new_node == NULL)
-        exit(1); // Exit if memory allocation fails.
-
-    // Initialize edge properties.
-    new_node->e.neighbor = neighbor;
-    new_node->e.cost = cost;
-    new_node->next = NULL;
-
-    return new_node;
-}
-
-EdgeList* build_net(int n) {
-    // Builds an adjacency list representation of a graph with n nodes.
+Graph* build_net(Reader* in, int n) {
+    // Builds a CSR representation of a graph with n nodes read from `in`.
     if (n < 0) {
         printf("Invalid input.");
         exit(1);
     }
-    EdgeList* net;
-    EdgeNode* Node_a_to_b, * Node_b_to_a;
-    int i, M, a, b, price;
-    bool IsEdge;
+    InputEdge* edges;
+    Graph* graph;
+    Arena* scratch;
+    int i, M, a, b, price, unique;
 
-    net = (EdgeList*)malloc(sizeof(EdgeList) * n);
-    if (net == NULL) {
+    printf("Enter the numbers of lines:");
+    fflush(stdout); // The reader bypasses stdio, so show the prompt before blocking.
+    if (!readInt(in, &M)) { // Read the number of edges.
+        printf("invalid input");
         exit(1);
     }
-    for (i = 0; i < n; i++) {
-        net[i].head = Make_list_With_Dummy(); // Initialize each list with dummy nodes.
-        net[i].tail = net[i].head->next;      // The tail points to the dummy tail node.
-    }
+    if (M < 0)
+        M = 0;
 
-    printf("Enter the numbers of lines:");
-    scanf("%d", &M); // Read the number of edges.
+    // Read every connection into one flat buffer before building the graph.
+    // All ingestion buffers share one scratch arena that is released in a single call.
+    scratch = makeArena(ARENA_DEFAULT_BLOCK);
+    edges = (InputEdge*)arenaAlloc(scratch, sizeof(InputEdge) * M);
 
     for (i = 0; i < M; i++) {
-        scanf("%d %d %d", &a, &b, &price); // Read edge information.
-        if (a > n || a < 0 || b > n || b < 0 || price < 0 || a==b) {
+        if (!readInt(in, &a) || !readInt(in, &b) || !readInt(in, &price))
+            a = -1; // A truncated line is rejected like any other invalid edge.
+        if (a >= n || a < 0 || b >= n || b < 0 || price < 0 || a==b) {
+            // Report the duplicates read so far, as if they had been checked one by one.
+            radixSortEdges(scratch, edges, i, n);
+            reportDuplicates(i - dedupeEdges(edges, i));
             printf("invalid input");
-            freeEdgeList(net, n);
+            freeArena(scratch);
             exit(1);
         }
-        IsEdge = Check_Edge(net, a, b); // Check if the connection is already set.
-        if (IsEdge) {
-            Node_a_to_b = Create_New_Node(b, price);
-            Node_b_to_a = Create_New_Node(a, price);
-
-            Sort_List(&net[a], Node_a_to_b); // Insert edge from a to b.
-            Sort_List(&net[b], Node_b_to_a); // Insert edge from b to a.
-        }
+        edges[i].a = a < b ? a : b; // Store the connection under its (low, high) key.
+        edges[i].b = a < b ? b : a;
+        edges[i].cost = price;
     }
 
-    return net;
+    // Sort by (low, high), drop repeated connections and build the adjacency in one pass.
+    radixSortEdges(scratch, edges, M, n);
+    unique = dedupeEdges(edges, M);
+    reportDuplicates(M - unique);
+    graph = edgesToGraph(scratch, edges, unique, n);
+
+    freeArena(scratch);
+    return graph;
+}
+
+void radixSortEdges(Arena* scratch, InputEdge* edges, int m, int n) {
+    // Sorts connections by (a, b) with buffers taken from `scratch`.
+    if (m < 2)
+        return;
+
+    radixSortEdgesWith(edges, (InputEdge*)arenaAlloc(scratch, sizeof(InputEdge) * m),
+        (int*)arenaAlloc(scratch, sizeof(int) * ((size_t)n + 1)), m, n);
 }
 
-void Sort_List(EdgeList* net, EdgeNode* node) {
-    // Inserts a node into the linked list in a sorted manner.
-    EdgeNode* temp;
-    temp = net->head; // Start from the head.
+void radixSortEdgesWith(InputEdge* edges, InputEdge* temp, int* count, int m, int n) {
+    // LSD radix sort with one counting pass per key (b, then a); both passes are stable,
+    // so repeated connections keep their input order. `temp` holds m edges, `count` n + 1 ints.
+    int pass, i, key;
 
-    while (temp->next != NULL) {
-        if (temp->next == net->tail) { // If next is the dummy tail node, insert before it.
-            node->next = temp->next;
-            temp->next = node;
-            return;
+    if (m < 2)
+        return;
+
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i <= n; i++)
+            count[i] = 0;
+        for (i = 0; i < m; i++) {
+            key = pass == 0 ? edges[i].b : edges[i].a;
+            count[key + 1]++;
         }
-        else {
-            // Keep traversing if the neighbor value is larger.
-            if (node->e.neighbor > temp->next->e.neighbor && temp->next->e.neighbor != -1)
-                temp = temp->next;
-            else {
-                // Insert the node at the correct position.
-                node->next = temp->next;
-                temp->next = node;
-                return;
-            }
+        for (i = 0; i < n; i++)
+            count[i + 1] += count[i]; // Turn the counts into starting positions.
+        for (i = 0; i < m; i++) {
+            key = pass == 0 ? edges[i].b : edges[i].a;
+            temp[count[key]++] = edges[i];
         }
+        memcpy(edges, temp, sizeof(InputEdge) * m);
+        STAT_ADD(radixMoves, m);
     }
 }
 
-void printNet(EdgeList* list, int len) {
-    // Prints the entire network.
-    int i;
-    for (i = 0; i < len; i++) {
-        printf("source: %d", i);
-        print_list_it(list[i].head);
+int dedupeEdges(InputEdge* edges, int m) {
+    // Compacts a sorted buffer so each (a, b) key appears once, keeping the earliest input.
+    int i, unique = 0;
+
+    STAT_ADD(duplicateChecks, m > 0 ? m - 1 : 0);
+    for (i = 0; i < m; i++) {
+        if (unique > 0 && edges[unique - 1].a == edges[i].a && edges[unique - 1].b == edges[i].b)
+            continue;
+        edges[unique++] = edges[i];
     }
+
+    return unique;
 }
 
-void print_list_it(EdgeNode* head) {
-    // Iteratively prints the edges of a node.
-    head = head->next; // Skip the dummy head node.
-    while (head->next != NULL) {
-        printf(" dest: %d, price: %d", head->e.neighbor, head->e.cost);
-        head = head->next;
+void reportDuplicates(int count) {
+    // A connection that is already set is ignored with a warning.
+    for (int i = 0; i < count; i++)
+        printf("Invalid input.\n");
+}
+
+Graph* edgesToGraph(Arena* scratch, InputEdge* edges, int m, int n) {
+    // Builds a CSR graph from connections sorted by (a, b) with a < b.
+    // Visiting them in that order appends every node's neighbors in ascending order:
+    // lower neighbors (as b) arrive before higher ones (as a), each group already sorted.
+    Graph* graph = makeGraph(n, 2 * m);
+
+    fillGraph(graph, edges, m, (int*)arenaAlloc(scratch, sizeof(int) * n));
+    return graph;
+}
+
+void fillGraph(Graph* graph, InputEdge* edges, int m, int* next) {
+    // Writes the CSR arrays of `graph` (n and room for 2 * m edges already set) from sorted
+    // connections; `next` is scratch for n write cursors.
+    int i, n = graph->n;
+
+    graph->m = 2 * m;
+    memset(graph->offsets, 0, sizeof(int) * ((size_t)n + 1));
+    for (i = 0; i < m; i++) {
+        graph->offsets[edges[i].a + 1]++;
+        graph->offsets[edges[i].b + 1]++;
+    }
+    for (i = 0; i < n; i++)
+        graph->offsets[i + 1] += graph->offsets[i];
+
+    memcpy(next, graph->offsets, sizeof(int) * n);
+
+    for (i = 0; i < m; i++) {
+        graph->neighbors[next[edges[i].a]] = edges[i].b; // Edge from a to b.
+        graph->costs[next[edges[i].a]++] = edges[i].cost;
+        graph->neighbors[next[edges[i].b]] = edges[i].a; // Edge from b to a.
+        graph->costs[next[edges[i].b]++] = edges[i].cost;
     }
-    printf("\n");
 }
 
-void freeEdgeList(EdgeList* Net, int n) {
-    // Frees the dynamically allocated memory of the adjacency list.
-    for (int i = 0; i < n; i++) {
-        EdgeNode* curr = Net[i].head;
-        while (curr != NULL) {
-            EdgeNode* next = curr->next;
-            if (next != NULL)
-                free(curr);
-            curr = next;
+Graph* makeGraph(int n, int m) {
+    // Allocates a CSR graph; the struct and its arrays share one exactly sized arena block.
+    size_t bytes = 4 * ARENA_ALIGN + sizeof(Graph) + sizeof(int) * ((size_t)n + 1 + 2 * (size_t)m);
+    Arena* arena = makeArena(bytes);
+    Graph* graph = (Graph*)arenaAlloc(arena, sizeof(Graph));
+
+    graph->n = n;
+    graph->m = m;
+    graph->offsets = (int*)arenaCalloc(arena, (size_t)n + 1, sizeof(int));
+    graph->neighbors = (int*)arenaAlloc(arena, sizeof(int) * m);
+    graph->costs = (int*)arenaAlloc(arena, sizeof(int) * m);
+    graph->arena = arena;
+    graph->mapping = NULL;
+    graph->mappingSize = 0;
+
+    return graph;
+}
+
+void sortSegment(Graph* graph, int v) {
+    // Insertion sort of node v's edges by neighbor; linear when they are almost sorted.
+    int i, j, neighbor, cost;
+
+    for (i = graph->offsets[v] + 1; i < graph->offsets[v + 1]; i++) {
+        neighbor = graph->neighbors[i];
+        cost = graph->costs[i];
+        for (j = i; j > graph->offsets[v] && graph->neighbors[j - 1] > neighbor; j--) {
+            graph->neighbors[j] = graph->neighbors[j - 1];
+            graph->costs[j] = graph->costs[j - 1];
+            STAT_ADD(segmentShifts, 1);
         }
+        graph->neighbors[j] = neighbor;
+        graph->costs[j] = cost;
     }
-    free(Net); // Free the entire network.
 }
 
+void printNet(Graph* graph) {
+    // Prints the entire network.
+    int i, j;
+    for (i = 0; i < graph->n; i++) {
+        printf("source: %d", i);
+        for (j = graph->offsets[i]; j < graph->offsets[i + 1]; j++)
+            printf(" dest: %d, price: %d", graph->neighbors[j], graph->costs[j]);
+        printf("\n");
+    }
+}
 
-bool Check_Edge(EdgeList* net, int a, int b) {
+int findEdgeCost(Graph* graph, int u, int v) {
+    // Binary search for v among u's (ascending) neighbors.
+    int lo = graph->offsets[u], hi = graph->offsets[u + 1] - 1, mid;
+
+    while (lo <= hi) {
+        mid = lo + (hi - lo) / 2;
+        STAT_ADD(edgeProbes, 1);
+        if (graph->neighbors[mid] == v)
+            return graph->costs[mid];
+        if (graph->neighbors[mid] < v)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return -1;
+}
 
-    EdgeNode* current = net[a].head->next;
-    while (current->next != NULL) {
-        if (current->e.neighbor == b) {
-            printf("Invalid input.\n");
-            return 0;
-        }
-        current = current->next;
+void freeGraph(Graph* graph) {
+    // Frees a CSR graph: one arena release, or the file mapping its arrays live in.
+    if (graph->arena != NULL) {
+        freeArena(graph->arena); // The struct itself lives in the arena.
+    }
+    else {
+        unmapFile(graph->mapping, graph->mappingSize);
+        free(graph);
     }
-    return 1;
 }
@@ -1,65 +1,115 @@
 #include "pro.h"
 
-int* build_prim_tree(EdgeList Net[], int n) {
+int* build_mst(Graph* Net, MstEngine engine, int threads) {
+    // Every engine produces the same `Prim` parent array layout (root 0 has parent -1).
+    if (engine == ENGINE_AUTO)
+        engine = chooseEngine(Net);
+    if (engine == ENGINE_PRIM && isDenseGraph(Net))
+        engine = ENGINE_DENSE; // Same parent array, but a vectorized scan beats the heap.
+    if (engine == ENGINE_DENSE)
+        return build_dense_prim_tree(Net);
+    if (engine == ENGINE_BORUVKA)
+        return build_boruvka_tree(Net, threads);
+    if (engine == ENGINE_KRUSKAL)
+        return build_kruskal_tree(Net);
+    return build_prim_tree(Net);
+}
+
+bool parseEngine(const char* name, MstEngine* engine) {
+    // Maps an --engine argument to its MstEngine; returns false for unknown names.
+    const char* names[] = { "prim", "boruvka", "kruskal", "auto", "dense" };
+    const MstEngine engines[] = { ENGINE_PRIM, ENGINE_BORUVKA, ENGINE_KRUSKAL, ENGINE_AUTO, ENGINE_DENSE };
+
+    for (int i = 0; i < 5; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *engine = engines[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* engineName(MstEngine engine) {
+    // Inverse of parseEngine, used in benchmark reports.
+    const char* names[] = { "prim", "boruvka", "kruskal", "auto", "dense" };
+    return names[engine];
+}
+
+int* build_prim_tree(Graph* Net) {
     // Implements Prim's Algorithm to build a Minimum Spanning Tree (MST).
-    int v0 = 0, i, min, v;
-
-    // Allocate memory for necessary arrays.
-    int* prim = buildPrim(n);   // Stores the MST parent relationships.
-    int* minArr = buildMinArr(n); // Stores minimum edge weights.
-    bool* inT = buildIntList(n); // Tracks nodes already added to the MST.
-
-    // Allocate memory for candidate locations.
-    CandidateNode** location = (CandidateNode**)calloc(n, sizeof(CandidateNode*));
-    if (location == NULL) {
-        printf("memory error");
-        exit(1); // Exit if memory allocation fails.
+    int n = Net->n;
+    PrimWorkspace ws;
+
+    // Allocate memory for necessary arrays; the workspace is released in one call at the end.
+    Arena* workspace = makeArena(4 * ARENA_ALIGN +
+        (size_t)n * (sizeof(int) + sizeof(bool) + sizeof(Candidate) + sizeof(int)));
+    int* prim = (int*)allocOrExit(sizeof(int) * n); // Stores the MST parent relationships.
+    ws.minArr = (int*)arenaAlloc(workspace, sizeof(int) * n);
+    ws.inT = (bool*)arenaAlloc(workspace, sizeof(bool) * n);
+    ws.priority.heap = (Candidate*)arenaAlloc(workspace, sizeof(Candidate) * n);
+    ws.priority.location = (int*)arenaAlloc(workspace, sizeof(int) * n);
+
+    if (!primWithWorkspace(Net, &ws, prim)) {
+        printf("Cannot build Prim"); // If node has INT_MAX cost, MST cannot be formed.
+        exit(1);
     }
 
-    // Build a priority queue for edge selection.
-    CandidateList* priority = buildPriority(n, Net, &location);
+    // Free allocated memory before returning the MST.
+    freeArena(workspace);
+    return prim;
+}
+
+bool primWithWorkspace(Graph* Net, PrimWorkspace* ws, int* prim) {
+    // Prim's loop on caller-owned buffers of at least Net->n entries, which it initializes.
+    // Returns false, with `prim` incomplete, if the network is not connected.
+    int n = Net->n, v0 = 0, v, j;
+    int* minArr = ws->minArr;
+    bool* inT = ws->inT;
+    CandidateHeap* priority = &ws->priority;
+
+    // All keys are equal (INT_MAX), so the identity order is already a valid heap.
+    for (v = 0; v < n; v++) {
+        prim[v] = -1; // Initialize all nodes with no parent.
+        minArr[v] = INT_MAX;
+        inT[v] = false;
+        priority->heap[v].computer = v;
+        priority->heap[v].min = INT_MAX;
+        priority->location[v] = v;
+    }
+    priority->size = n;
+    if (n == 0)
+        return true;
+
     minArr[v0] = 0; // Initialize starting node cost to 0.
-    prim[v0] = -1;  // Root node has no parent.
+    decreaseKey(priority, v0, 0);
 
     // Process nodes until priority queue is empty.
-    while (priority->head->next != priority->tail) {
-        int u = deleteMin(priority, location); // Extract minimum-cost node.
-
-        if (minArr[u] == INT_MAX) {
-            printf("Cannot build Prim"); // If node has INT_MAX cost, MST cannot be formed.
-            exit(1);
-        }
-        else {
-            inT[u] = true; // Mark node as added to MST.
-
-            // Iterate through the neighbors of the current node.
-            EdgeNode* uNeighbor = Net[u].head->next;
-            while (uNeighbor != Net[u].tail) {
-                v = uNeighbor->e.neighbor;
-
-                // If `v` is not in MST and its cost is lower, update its information.
-                if ((!inT[v]) && (uNeighbor->e.cost < minArr[v])) {
-                    minArr[v] = uNeighbor->e.cost; // Update minimum cost.
-                    prim[v] = u; // Set parent node in MST.
-                    decreaseKey(location, v, uNeighbor->e.cost); // Update priority queue.
-                }
-                uNeighbor = uNeighbor->next;
+    while (priority->size > 0) {
+        int u = deleteMin(priority); // Extract minimum-cost node.
+
+        if (minArr[u] == INT_MAX)
+            return false; // If node has INT_MAX cost, MST cannot be formed.
+        inT[u] = true; // Mark node as added to MST.
+
+        // Iterate through the neighbors of the current node.
+        for (j = Net->offsets[u]; j < Net->offsets[u + 1]; j++) {
+            v = Net->neighbors[j];
+
+            // If `v` is not in MST and its cost is lower, update its information.
+            if ((!inT[v]) && (Net->costs[j] < minArr[v])) {
+                minArr[v] = Net->costs[j]; // Update minimum cost.
+                prim[v] = u; // Set parent node in MST.
+                decreaseKey(priority, v, Net->costs[j]); // Update priority queue.
             }
         }
     }
 
-    // Free allocated memory before returning the MST.
-    freeFun(minArr, inT, location, priority);
-    return prim;
+    return true;
 }
 
 int* buildPrim(int n) {
     // Allocates and initializes the parent array for Prim's Algorithm.
-    int* prim = (int*)malloc(sizeof(int) * n);
-    if (prim == NULL) {
-        printf("memory error");
-        exit(1);
-    }
+    int* prim = (int*)allocOrExit(sizeof(int) * n);
 
     for (int i = 0; i < n; i++)
         prim[i] = -1; // Initialize all nodes with no parent.
@@ -67,23 +117,14 @@ int* buildPrim(int n) {
     return prim;
 }
 
-bool* buildIntList(int n) {
+bool* buildIntList(Arena* arena, int n) {
     // Allocates and initializes a boolean array to track visited nodes.
-    bool* inT = (bool*)calloc(n, sizeof(bool));
-    if (inT == NULL) {
-        printf("memory error");
-        exit(1);
-    }
-    return inT;
+    return (bool*)arenaCalloc(arena, n, sizeof(bool));
 }
 
-int* buildMinArr(int n) {
+int* buildMinArr(Arena* arena, int n) {
     // Allocates and initializes an array for minimum edge weights.
-    int* min = (int*)malloc(n * sizeof(int));
-    if (min == NULL) {
-        printf("memory error");
-        exit(1);
-    }
+    int* min = (int*)arenaAlloc(arena, n * sizeof(int));
 
     for (int i = 0; i < n; i++)
         min[i] = INT_MAX; // Initialize all nodes with max cost.
@@ -91,131 +132,115 @@ int* buildMinArr(int n) {
     return min;
 }
 
-CandidateList* buildPriority(int vNum, EdgeList* Net, CandidateNode*** location) {
+CandidateHeap* buildPriority(Arena* arena, int vNum) {
     // Creates and initializes a priority queue for Prim's Algorithm.
+    CandidateHeap* priority = (CandidateHeap*)arenaAlloc(arena, sizeof(CandidateHeap));
 
-    CandidateList* candidLst = makeEmptyCandidList();
-    CandidateNode* tempHead = candidLst->head;
+    // One allocation each for the heap array and the position index.
+    priority->heap = (Candidate*)arenaAlloc(arena, sizeof(Candidate) * vNum);
+    priority->location = (int*)arenaAlloc(arena, sizeof(int) * vNum);
 
+    // All keys are equal (INT_MAX), so the identity order is already a valid heap.
     for (int i = 0; i < vNum; i++) {
-        // Allocate a new candidate node.
-        CandidateNode* candNode = (CandidateNode*)malloc(sizeof(CandidateNode));
-        if (candNode == NULL) {
-            printf("memory error");
-            exit(1);
-        }
-
-        candNode->c.computer = i; // Assign node index.
-        candNode->c.min = INT_MAX; // Default cost to maximum.
-
-        (*location)[i] = candNode; // Store location reference.
-
-        // Insert node into the priority queue.
-        tempHead->next = candNode;
-        candNode->prev = tempHead;
-        tempHead = candNode;
+        priority->heap[i].computer = i;
+        priority->heap[i].min = INT_MAX;
+        priority->location[i] = i;
     }
+    priority->size = vNum;
 
-    // Link the last node to the priority queue tail.
-    tempHead->next = candidLst->tail;
-    candidLst->tail->prev = tempHead;
-
-    return candidLst;
+    return priority;
 }
 
-void print_list_Com(CandidateNode* head) {
-    // Iteratively prints the priority queue of candidates.
-    head = head->next;
-    while (head->next->next != NULL) {
-        printf(" COM: %d, MIN: %d\n", head->c.computer, head->c.min);
-        head = head->next;
-    }
+void print_list_Com(CandidateHeap* priority) {
+    // Prints the priority queue of candidates in heap order.
+    for (int i = 0; i < priority->size; i++)
+        printf(" COM: %d, MIN: %d\n", priority->heap[i].computer, priority->heap[i].min);
     printf("\n");
 }
 
-CandidateList* makeEmptyCandidList() {
-    // Creates an empty candidate list with dummy head and tail nodes.
-
-    CandidateList* candLst = (CandidateList*)calloc(1, sizeof(CandidateList));
-    if (candLst == NULL) {
-        printf("memory error");
-        exit(1);
-    }
+bool candidateLess(Candidate x, Candidate y) {
+    // Ties on cost go to the lower node id, matching the order of the old linear scan.
+    if (x.min != y.min)
+        return x.min < y.min;
+    return x.computer < y.computer;
+}
 
-    candLst->head = (CandidateNode*)calloc(1, sizeof(CandidateNode));
-    candLst->tail = (CandidateNode*)calloc(1, sizeof(CandidateNode));
-    if (candLst->head == NULL || candLst->tail == NULL) {
-        printf("memory error");
-        exit(1);
+void siftUp(CandidateHeap* priority, int pos) {
+    // Moves the candidate at `pos` up while it is smaller than its parent.
+    Candidate item = priority->heap[pos];
+
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!candidateLess(item, priority->heap[parent]))
+            break;
+        priority->heap[pos] = priority->heap[parent];
+        priority->location[priority->heap[pos].computer] = pos;
+        pos = parent;
     }
 
-    // Initialize head and tail links.
-    candLst->head->prev = NULL;
-    candLst->tail->next = NULL;
-    candLst->head->next = candLst->tail;
-    candLst->tail->prev = candLst->head;
+    priority->heap[pos] = item;
+    priority->location[item.computer] = pos;
+}
 
-    // Assign default values to dummy nodes.
-    candLst->head->c.computer = -1;
-    candLst->tail->c.computer = -1;
-    candLst->head->c.min = INT_MAX;
-    candLst->tail->c.min = INT_MAX;
+void siftDown(CandidateHeap* priority, int pos) {
+    // Moves the candidate at `pos` down while one of its children is smaller.
+    Candidate item = priority->heap[pos];
+    int size = priority->size;
+
+    while (2 * pos + 1 < size) {
+        int child = 2 * pos + 1;
+        if (child + 1 < size && candidateLess(priority->heap[child + 1], priority->heap[child]))
+            child++;
+        STAT_ADD(siftDownSteps, 1);
+        if (!candidateLess(priority->heap[child], item))
+            break;
+        priority->heap[pos] = priority->heap[child];
+        priority->location[priority->heap[pos].computer] = pos;
+        pos = child;
+    }
 
-    return candLst;
+    priority->heap[pos] = item;
+    priority->location[item.computer] = pos;
 }
 
-int deleteMin(CandidateList* priority, CandidateNode** location) {
+int deleteMin(CandidateHeap* priority) {
     // Removes the node with the minimum cost from the priority queue.
-
-    CandidateNode* curr = priority->head->next;
-    CandidateNode* minComVal = curr;
     int v;
 
-    if (curr == priority->tail) {
+    if (priority->size == 0) {
         printf("Priority list is empty!\n");
         return -1;
     }
 
-    while (curr != priority->tail) {
-        if (curr->c.min < minComVal->c.min)
-            minComVal = curr;
-        curr = curr->next;
-    }
-
-    v = minComVal->c.computer;
+    STAT_ADD(heapPops, 1);
+    v = priority->heap[0].computer;
+    priority->location[v] = -1;
 
-    // Remove node from the list and free memory.
-    minComVal->prev->next = minComVal->next;
-    minComVal->next->prev = minComVal->prev;
-    location[minComVal->c.computer] = NULL;
-    free(minComVal);
+    // Move the last candidate to the root and restore heap order.
+    priority->size--;
+    if (priority->size > 0) {
+        priority->heap[0] = priority->heap[priority->size];
+        siftDown(priority, 0);
+    }
 
     return v;
 }
 
-void decreaseKey(CandidateNode** location, int v, int minCost) {
-    // Updates the minimum cost of node `v` in the priority queue.
-    if (location[v] != NULL) {
-        CandidateNode* node = location[v];
-        node->c.min = minCost;
+void decreaseKey(CandidateHeap* priority, int v, int minCost) {
+    // Lowers the cost of node `v` if it is still waiting in the priority queue.
+    int pos = priority->location[v];
+    STAT_ADD(decreaseKeyCalls, 1);
+    if (pos != -1 && minCost < priority->heap[pos].min) {
+        STAT_ADD(decreaseKeyLowered, 1);
+        priority->heap[pos].min = minCost;
+        siftUp(priority, pos);
     }
 }
 
-void freeFun(int* minArr, bool* inT, CandidateNode** location, CandidateList* priority) {
-    // Frees allocated memory for Prim's Algorithm.
-    freeCandidateList(priority);
-    free(inT);
-    free(minArr);
-    free(location);
+void insertCandidate(CandidateHeap* priority, int v, int minCost) {
+    // Appends node `v` as a new leaf and sifts it up; the heap storage must have room.
+    priority->heap[priority->size].computer = v;
+    priority->heap[priority->size].min = minCost;
+    priority->size++;
+    siftUp(priority, priority->size - 1);
 }
-
-void freeCandidateList(CandidateList* list) {
-    // Frees all memory allocated for the priority queue.
-    CandidateNode* curr = list->head;
-    while (curr != NULL) {
-        CandidateNode* next = curr->next;
-        free(curr);
-        curr = next;
-    }
-    free(list);
-}
\ No newline at end of file
@@ -1,31 +1,102 @@
 #include "pro.h"
 
-EdgeList* build_paths(int* Prim, int n) {
-    // Creates an adjacency list representation of Prim's minimum spanning tree (MST).
-    int i, j;
-    EdgeNode* newNode1, * newNode2;
+Graph* build_paths(int* Prim, int* parentCost, int n) {
+    // Creates a CSR representation of Prim's minimum spanning tree (MST). Every tree edge
+    // keeps its cost from `parentCost`, or 0 when the costs are not known (NULL).
+    int i, edges = 0;
 
-    // Allocate memory for the adjacency list.
-    EdgeList* PrimPath = (EdgeList*)malloc(sizeof(EdgeList) * n);
+    // Each tree edge is stored in both directions.
+    for (i = 0; i < n; i++)
+        if (Prim[i] != -1)
+            edges += 2;
 
-    // Initialize each list with dummy head and tail nodes.
+    Graph* PrimPath = makeGraph(n, edges);
+    int* next = (int*)allocOrExit(sizeof(int) * ((size_t)n + 1));
+    fillPaths(PrimPath, Prim, parentCost, next);
+    free(next);
+
+    return PrimPath; // Return the CSR representation of the MST.
+}
+
+void fillPaths(Graph* PrimPath, int* Prim, int* parentCost, int* next) {
+    // Writes the tree CSR into `PrimPath` (n set, room for 2 * (n - 1) edges); `next` is
+    // scratch for n + 1 ints.
+    int i, n = PrimPath->n;
+
+    // Count the tree degree of every node, then turn the counts into offsets.
+    memset(PrimPath->offsets, 0, sizeof(int) * ((size_t)n + 1));
     for (i = 0; i < n; i++) {
-        PrimPath[i].head = Make_list_With_Dummy();
-        PrimPath[i].tail = PrimPath[i].head->next;
+        if (Prim[i] != -1) {
+            PrimPath->offsets[i + 1]++;
+            PrimPath->offsets[Prim[i] + 1]++;
+        }
     }
+    for (i = 0; i < n; i++)
+        PrimPath->offsets[i + 1] += PrimPath->offsets[i];
+    PrimPath->m = PrimPath->offsets[n];
+
+    // The write cursor of every node.
+    for (i = 0; i < n; i++)
+        next[i] = PrimPath->offsets[i];
 
     // Construct the MST paths based on the `Prim` array.
     for (i = 0; i < n; i++) {
         // Create bidirectional edges between nodes.
         if (Prim[i] != -1) {
-            newNode1 = Create_New_Node(Prim[i], 0); // Edge from node `i` to its parent.
-            newNode2 = Create_New_Node(i, 0);      // Edge from parent to node `i`.
+            int cost = parentCost != NULL ? parentCost[i] : 0;
+            PrimPath->neighbors[next[i]] = Prim[i]; // Edge from node `i` to its parent.
+            PrimPath->costs[next[i]++] = cost;
+            PrimPath->neighbors[next[Prim[i]]] = i; // Edge from parent to node `i`.
+            PrimPath->costs[next[Prim[i]]++] = cost;
+        }
+    }
+
+    // Children arrive in ascending order; only the parent edge may be out of place.
+    for (i = 0; i < n; i++)
+        sortSegment(PrimPath, i);
+}
+
+int* treeToPrim(InputEdge* tree, int count, int n) {
+    // Orients tree edges into a parent array with a BFS from node 0 (and from every
+    // node not reached yet, so a forest gets one root per tree). The edges may come in any
+    // order and orientation; they are turned to a < b and sorted in place for edgesToGraph.
+    Arena* scratch = makeArena(ARENA_DEFAULT_BLOCK);
+    Graph* adjacency;
+    int* queue = (int*)arenaAlloc(scratch, sizeof(int) * n);
+    bool* seen = (bool*)arenaCalloc(scratch, n, sizeof(bool));
+    int* prim = buildPrim(n);
+    int root, head, tail, u, j;
+
+    for (j = 0; j < count; j++) {
+        if (tree[j].a > tree[j].b) {
+            int swap = tree[j].a;
+            tree[j].a = tree[j].b;
+            tree[j].b = swap;
+        }
+    }
+    radixSortEdges(scratch, tree, count, n);
+    adjacency = edgesToGraph(scratch, tree, count, n);
 
-            // Insert edges into the sorted adjacency list.
-            Sort_List(&PrimPath[i], newNode1);
-            Sort_List(&PrimPath[Prim[i]], newNode2);
+    for (root = 0; root < n; root++) {
+        if (seen[root])
+            continue;
+        seen[root] = true;
+        head = tail = 0;
+        queue[tail++] = root;
+        while (head < tail) {
+            u = queue[head++];
+            for (j = adjacency->offsets[u]; j < adjacency->offsets[u + 1]; j++) {
+                int v = adjacency->neighbors[j];
+                if (!seen[v]) {
+                    seen[v] = true;
+                    prim[v] = u;
+                    queue[tail++] = v;
+                }
+            }
         }
     }
 
-    return PrimPath; // Return the adjacency list representation of the MST.
-}
\ No newline at end of file
+    freeGraph(adjacency);
+    freeArena(scratch);
+    return prim;
+}
@@ -1,36 +1,94 @@
 #include "pro.h"
 
-void find_and_print_path(EdgeList* primpath, int size, int first, int last) {
-    // Allocates memory and initializes arrays for tracking paths.
-    if (first > size || first<0 || last>size || last < 0) {
+PathWorkspace* makePathWorkspace(int n) {
+    // Allocates the per-query state once; the stamps start at 0, so every node reads as WHITE.
+    Arena* arena = makeArena(6 * ARENA_ALIGN + sizeof(PathWorkspace) + (size_t)n * 5 * sizeof(int));
+    PathWorkspace* ws = (PathWorkspace*)arenaAlloc(arena, sizeof(PathWorkspace));
+
+    ws->n = n;
+    ws->epoch = 0;
+    ws->stamp = (unsigned int*)arenaCalloc(arena, n, sizeof(unsigned int));
+    ws->color = (int*)arenaAlloc(arena, sizeof(int) * n);
+    ws->parent = (int*)arenaAlloc(arena, sizeof(int) * n);
+    ws->stack = (int*)arenaAlloc(arena, sizeof(int) * n);
+    ws->edge = (int*)arenaAlloc(arena, sizeof(int) * n);
+    ws->component = NULL;
+    ws->arena = arena;
+
+    return ws;
+}
+
+void freePathWorkspace(PathWorkspace* ws) {
+    // The workspace struct and its arrays live in one arena.
+    freeArena(ws->arena);
+}
+
+void labelPathComponents(PathWorkspace* ws, int* Prim) {
+    // Labels every node with the root of its tree in `Prim`, so a query between two trees
+    // of a spanning forest is answered NO PATH without a search. The stack serves as scratch.
+    int n = ws->n, v, u, top;
+    int* label = (int*)arenaAlloc(ws->arena, sizeof(int) * n);
+
+    for (v = 0; v < n; v++)
+        label[v] = -1;
+    for (v = 0; v < n; v++) {
+        top = 0;
+        for (u = v; label[u] == -1 && Prim[u] != -1; u = Prim[u])
+            ws->stack[top++] = u;
+        if (label[u] == -1)
+            label[u] = u;
+        while (top > 0)
+            label[ws->stack[--top]] = label[u];
+    }
+    ws->component = label;
+}
+
+void visitNode(PathWorkspace* ws, int v, int color, int parent) {
+    // Stamps `v` for the current query and records its color and parent.
+    STAT_ADD(dfsNodesVisited, 1);
+    ws->stamp[v] = ws->epoch;
+    ws->color[v] = color;
+    ws->parent[v] = parent;
+}
+
+int nodeColor(PathWorkspace* ws, int v) {
+    // A node not stamped by the current query is unvisited.
+    return ws->stamp[v] == ws->epoch ? ws->color[v] : WHITE;
+}
+
+void find_and_print_path(Graph* primpath, PathWorkspace* ws, int first, int last) {
+    // Finds and prints the path using the reusable workspace; nothing is allocated per query.
+    int size = primpath->n;
+    if (first >= size || first<0 || last>=size || last < 0) {
         printf("invalid input");
         exit(1);
     }
-    int* color, * parent;
-    color = (int*)malloc(sizeof(int) * size);
-    parent = (int*)malloc(sizeof(int) * size);
+    STAT_ADD(pathQueries, 1);
 
-    if (color == NULL || parent == NULL)
-        exit(1); // Exit if memory allocation fails.
-
-    // Initialize arrays: `color` tracks visit state, `parent` tracks path connections.
-    for (int i = 0; i < size; i++) {
-        color[i] = WHITE; // All nodes initially unvisited.
-        parent[i] = -1; // No parent assigned yet.
+    // Nodes in different components of a spanning forest are never connected.
+    if (ws->component != NULL && ws->component[first] != ws->component[last]) {
+        printf("NO PATH\n");
+        return;
     }
 
     // Find the path and print it.
-    Findpath(primpath, color, parent, first, last);
-    printpathrec(first, last, parent);
+    startPathQuery(ws);
+    if (Findpath(primpath, ws, first, last) != NULL)
+        printpathit(ws, first, last);
+}
 
-    // Free allocated memory after use.
-    free(color);
-    free(parent);
+void startPathQuery(PathWorkspace* ws) {
+    // Starts a new query: bumping the epoch invalidates every old stamp in O(1).
+    STAT_ADD(dfsQueries, 1);
+    if (++ws->epoch == 0) {
+        memset(ws->stamp, 0, sizeof(unsigned int) * ws->n); // Wrapped around; clear once.
+        ws->epoch = 1;
+    }
 }
 
-int* Findpath(EdgeList* primpath, int* color, int* parent, int first, int last) {
-    // Calls the recursive function to find the path.
-    int* path = Findpathrec(primpath, color, parent, first, last);
+int* Findpath(Graph* primpath, PathWorkspace* ws, int first, int last) {
+    // Calls the iterative search to find the path.
+    int* path = Findpathit(primpath, ws, first, last);
 
     if (path == NULL) {
         printf("NO PATH\n"); // Indicates no valid path was found.
@@ -39,51 +97,57 @@ int* Findpath(EdgeList* primpath, int* color, int* parent, int first, int last)
     return path;
 }
 
-int* Findpathrec(EdgeList* primpath, int* color, int* parent, int first, int last) {
-    // Recursive function to search for a path in the graph.
-
-    EdgeNode* current = primpath[first].head->next;
-    int neighbor;
-    int* path;
-
-    color[first] = GRAY; // Mark the node as being processed.
-
-    // Traverse through adjacency list of `first` node.
-    while (current->next != NULL) {
-        neighbor = current->e.neighbor;
+int* Findpathit(Graph* primpath, PathWorkspace* ws, int first, int last) {
+    // Depth-first search with an explicit stack, so deep trees cannot overflow the call stack.
+    // ws->edge[i] is the next edge to examine for the node at ws->stack[i].
+    int top = 0, u, j, neighbor;
+
+    visitNode(ws, first, GRAY, -1); // Mark the node as being processed.
+    if (first == last)
+        return ws->parent; // The one-node path, even for a node without tree edges.
+    ws->stack[top] = first;
+    ws->edge[top++] = primpath->offsets[first];
+
+    while (top > 0) {
+        u = ws->stack[top - 1];
+        j = ws->edge[top - 1];
+
+        if (j == primpath->offsets[u + 1]) {
+            ws->color[u] = BLACK; // All edges of `u` examined: mark as fully processed.
+            top--;
+            continue;
+        }
+        ws->edge[top - 1]++;
+        neighbor = primpath->neighbors[j];
 
         if (neighbor == last) { // If we reached the destination, update parent.
-            parent[neighbor] = first;
-            color[neighbor] = BLACK; // Mark as fully processed.
-            return parent;
+            visitNode(ws, neighbor, BLACK, u);
+            return ws->parent;
         }
 
-        // Explore unvisited neighbors recursively.
-        if (color[neighbor] == WHITE) {
-            parent[neighbor] = first;
-            path = Findpathrec(primpath, color, parent, neighbor, last);
-
-            if (path != NULL) // If a valid path is found, return it.
-                return path;
+        // Descend into unvisited neighbors.
+        if (nodeColor(ws, neighbor) == WHITE) {
+            visitNode(ws, neighbor, GRAY, u);
+            ws->stack[top] = neighbor;
+            ws->edge[top++] = primpath->offsets[neighbor];
         }
-
-        current = current->next;
     }
 
-    color[first] = BLACK; // Mark node as fully processed.
     return NULL; // No path found.
 }
 
-int printpathrec(int first, int last, int* parent) {
-    // Recursively prints the path from `first` to `last`.
+int printpathit(PathWorkspace* ws, int first, int last) {
+    // Prints the path from `first` to `last` by walking the parents back and printing in reverse.
+    int count = 0, v = last;
 
-    if (last == first) {
-        printf("%d ", last); // Base case: print the first node.
-    }
-    else {
-        printpathrec(first, parent[last], parent); // Recursively print parent nodes.
-        printf("%d ", last); // Print the current node after recursion unwinds.
+    ws->stack[count++] = v;
+    while (v != first) {
+        v = ws->parent[v];
+        ws->stack[count++] = v;
     }
 
+    while (count > 0)
+        printf("%d ", ws->stack[--count]);
+
     return 0;
 }
@@ -0,0 +1,188 @@
+#include "pro.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void saveGraph(Graph* graph, const char* path) {
+    // Writes the header followed by the three CSR arrays, each with a single fwrite.
+    GraphFileHeader header;
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("cannot open %s", path);
+        exit(1);
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.magic = GRAPH_FILE_MAGIC;
+    header.version = GRAPH_FILE_VERSION;
+    header.flags = GRAPH_FLAG_SORTED;
+    header.n = graph->n;
+    header.m = graph->m;
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(graph->offsets, sizeof(int), (size_t)graph->n + 1, file) != (size_t)graph->n + 1 ||
+        fwrite(graph->neighbors, sizeof(int), graph->m, file) != (size_t)graph->m ||
+        fwrite(graph->costs, sizeof(int), graph->m, file) != (size_t)graph->m) {
+        printf("cannot write %s", path);
+        exit(1);
+    }
+
+    fclose(file);
+}
+
+Graph* loadGraph(const char* path) {
+    // Maps a binary graph file and points a Graph at the arrays inside the mapping.
+    size_t size, expected;
+    GraphFileHeader* header;
+    Graph* graph;
+    int* data;
+
+    char* mapping = (char*)mapFile(path, &size);
+    if (size < sizeof(GraphFileHeader)) {
+        printf("invalid graph file");
+        exit(1);
+    }
+
+    header = (GraphFileHeader*)mapping;
+    if (header->magic != GRAPH_FILE_MAGIC || header->version != GRAPH_FILE_VERSION ||
+        (header->flags & GRAPH_FLAG_SORTED) == 0 || header->n < 0 || header->m < 0) {
+        printf("invalid graph file");
+        exit(1);
+    }
+
+    // The file must hold exactly the arrays the header announces.
+    expected = sizeof(GraphFileHeader) + sizeof(int) * ((size_t)header->n + 1 + 2 * (size_t)header->m);
+    data = (int*)(mapping + sizeof(GraphFileHeader));
+    if (size != expected || data[0] != 0 || data[header->n] != header->m) {
+        printf("invalid graph file");
+        exit(1);
+    }
+
+    graph = (Graph*)allocOrExit(sizeof(Graph));
+    graph->n = header->n;
+    graph->m = header->m;
+    graph->offsets = data;
+    graph->neighbors = data + header->n + 1;
+    graph->costs = graph->neighbors + header->m;
+    graph->arena = NULL;
+    graph->mapping = mapping;
+    graph->mappingSize = size;
+
+    if (!validGraph(graph)) {
+        printf("invalid graph file");
+        exit(1);
+    }
+    return graph;
+}
+
+bool validGraph(Graph* graph) {
+    // Every later pass trusts the arrays, so a damaged file is rejected before they run:
+    // offsets must not decrease, each row must list other nodes in ascending order (the
+    // binary search of findEdgeCost), costs must not be negative (the radix digits, dense
+    // kernels and varints), and every edge must be stored in both directions with one cost.
+    int n = graph->n, v, j, u, k;
+    int* next;
+    bool valid = true;
+
+    for (v = 0; v < n; v++) {
+        if (graph->offsets[v] > graph->offsets[v + 1])
+            return false;
+        for (j = graph->offsets[v]; j < graph->offsets[v + 1]; j++) {
+            int neighbor = graph->neighbors[j];
+            if (neighbor < 0 || neighbor >= n || neighbor == v || graph->costs[j] < 0 ||
+                (j > graph->offsets[v] && graph->neighbors[j - 1] >= neighbor))
+                return false;
+        }
+    }
+
+    // Rows are visited in ascending order, so the entries below the diagonal of row u are
+    // matched in order by the rows that list u: one cursor per row makes this O(n + m).
+    next = (int*)allocOrExit(sizeof(int) * ((size_t)n + 1));
+    for (v = 0; v < n; v++)
+        next[v] = graph->offsets[v];
+    for (v = 0; v < n && valid; v++) {
+        for (j = graph->offsets[v]; j < graph->offsets[v + 1] && graph->neighbors[j] < v; j++)
+            ;
+        if (next[v] != j)
+            valid = false; // A lower neighbor whose row does not list v.
+        for (; j < graph->offsets[v + 1] && valid; j++) {
+            u = graph->neighbors[j];
+            k = next[u]++;
+            if (k >= graph->offsets[u + 1] || graph->neighbors[k] != v || graph->costs[k] != graph->costs[j])
+                valid = false;
+        }
+    }
+    free(next);
+    return valid;
+}
+
+#ifdef _WIN32
+
+void* mapFile(const char* path, size_t* size) {
+    // Maps a whole file read-only with a Win32 file mapping.
+    LARGE_INTEGER length;
+    HANDLE mappingHandle;
+    void* view;
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &length) || length.QuadPart == 0) {
+        printf("cannot open %s", path);
+        exit(1);
+    }
+
+    mappingHandle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    view = mappingHandle != NULL ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (view == NULL) {
+        printf("cannot map %s", path);
+        exit(1);
+    }
+
+    // The view keeps the mapping alive on its own.
+    CloseHandle(mappingHandle);
+    CloseHandle(file);
+    *size = (size_t)length.QuadPart;
+    return view;
+}
+
+void unmapFile(void* mapping, size_t size) {
+    (void)size;
+    UnmapViewOfFile(mapping);
+}
+
+#else
+
+void* mapFile(const char* path, size_t* size) {
+    // Maps a whole file read-only with mmap.
+    struct stat info;
+    void* view;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0) {
+        printf("cannot open %s", path);
+        exit(1);
+    }
+
+    view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        printf("cannot map %s", path);
+        exit(1);
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    *size = (size_t)info.st_size;
+    return view;
+}
+
+void unmapFile(void* mapping, size_t size) {
+    munmap(mapping, size);
+}
+
+#endif
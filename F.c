@@ -0,0 +1,128 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // Exposes fileno() under strict ISO C modes.
+#endif
+#include "pro.h"
+
+#ifdef _WIN32
+#include <io.h>
+#define fileno _fileno
+#define readBlock(fd, buf, len) _read(fd, buf, (unsigned int)(len))
+#else
+#include <unistd.h>
+#define readBlock(fd, buf, len) read(fd, buf, len)
+#endif
+
+Reader* openReader(FILE* file) {
+    // Creates a block reader over `file`; it reads the descriptor directly, bypassing stdio.
+    Reader* in = (Reader*)allocOrExit(sizeof(Reader));
+    in->buffer = (char*)allocOrExit(READER_BLOCK_SIZE);
+
+    in->fd = fileno(file);
+    in->len = 0;
+    in->pos = 0;
+    in->eof = false;
+    in->badToken = false;
+
+    return in;
+}
+
+bool refillReader(Reader* in) {
+    // Loads the next block; a short read is fine, so interactive input is not held back.
+    long got;
+
+    if (in->eof)
+        return false;
+
+    got = (long)readBlock(in->fd, in->buffer, READER_BLOCK_SIZE);
+    if (got <= 0) {
+        in->eof = true;
+        in->len = in->pos = 0;
+        return false;
+    }
+
+    in->len = (size_t)got;
+    in->pos = 0;
+    return true;
+}
+
+bool readInt(Reader* in, int* value) {
+    // Parses the next optionally signed decimal integer; returns false at end of input.
+    // A token that is not a number (or runs on past its digits) is skipped whole and also
+    // returns false, with `badToken` set, so a caller that goes on reads the next token.
+    long long result = 0;
+    bool negative = false, digits = false;
+    char c;
+
+    in->badToken = false;
+    // Skip whitespace, refilling as blocks run out.
+    for (;;) {
+        if (in->pos == in->len && !refillReader(in))
+            return false;
+        c = in->buffer[in->pos];
+        if (!isTokenEnd(c))
+            break;
+        in->pos++;
+    }
+
+    if (c == '-' || c == '+') {
+        negative = c == '-';
+        in->pos++;
+    }
+
+    // Accumulate digits; a token may continue across a block boundary.
+    for (;;) {
+        if (in->pos == in->len && !refillReader(in))
+            break;
+        c = in->buffer[in->pos];
+        if (c < '0' || c > '9')
+            break;
+        if (result <= INT_MAX)
+            result = result * 10 + (c - '0');
+        digits = true;
+        in->pos++;
+    }
+
+    if (!digits || (in->pos < in->len && !isTokenEnd(in->buffer[in->pos]))) {
+        // Not a number: skip the rest of the token.
+        while ((in->pos < in->len || refillReader(in)) && !isTokenEnd(in->buffer[in->pos]))
+            in->pos++;
+        in->badToken = true;
+        return false;
+    }
+
+    if (result > INT_MAX)
+        result = negative ? (long long)INT_MAX + 1 : INT_MAX; // Saturate like strtol.
+    *value = negative ? (int)-result : (int)result;
+    return true;
+}
+
+bool isTokenEnd(char c) {
+    // Whitespace ends a token.
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+void skipLine(Reader* in) {
+    // Drops the rest of the current line, including its newline.
+    while (in->pos < in->len || refillReader(in)) {
+        if (in->buffer[in->pos++] == '\n')
+            return;
+    }
+}
+
+void closeReader(Reader* in) {
+    // Frees the reader; the underlying file stays open.
+    free(in->buffer);
+    free(in);
+}
+
+bool inputPending(Reader* in) {
+    // Skips whitespace in the current block and reports whether unread input is buffered,
+    // without blocking for more.
+    while (in->pos < in->len) {
+        char c = in->buffer[in->pos];
+        if (!isTokenEnd(c))
+            return true;
+        in->pos++;
+    }
+    return false;
+}
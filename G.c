@@ -0,0 +1,72 @@
+#include "pro.h"
+
+Arena* makeArena(size_t blockSize) {
+    // Creates an empty arena; the first block is allocated on the first request.
+    Arena* arena = (Arena*)allocOrExit(sizeof(Arena));
+    arena->head = NULL;
+    arena->blockSize = blockSize > 0 ? blockSize : ARENA_DEFAULT_BLOCK;
+    arena->bytes = 0;
+    return arena;
+}
+
+void* allocOrExit(size_t size) {
+    // The single place where an allocation failure ends the program.
+    void* memory = malloc(size > 0 ? size : 1);
+    STAT_ADD(allocations, 1);
+    STAT_ADD(allocatedBytes, (long long)size);
+    if (memory == NULL) {
+        printf("memory error");
+        exit(1);
+    }
+    return memory;
+}
+
+void* reallocOrExit(void* memory, size_t size) {
+    // Resizes a block allocated by allocOrExit; counted like a new allocation of `size`.
+    memory = realloc(memory, size > 0 ? size : 1);
+    STAT_ADD(allocations, 1);
+    STAT_ADD(allocatedBytes, (long long)size);
+    if (memory == NULL) {
+        printf("memory error");
+        exit(1);
+    }
+    return memory;
+}
+
+void* arenaAlloc(Arena* arena, size_t size) {
+    // Bump-allocates `size` bytes, aligned to ARENA_ALIGN, chaining a new block when needed.
+    ArenaBlock* block = arena->head;
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    if (block == NULL || block->size - block->used < size) {
+        size_t capacity = size > arena->blockSize ? size : arena->blockSize;
+        block = (ArenaBlock*)allocOrExit(sizeof(ArenaBlock) + capacity);
+        block->size = capacity;
+        block->used = 0;
+        block->next = arena->head;
+        arena->head = block;
+    }
+
+    void* memory = block->data + block->used;
+    block->used += size;
+    arena->bytes += size;
+    return memory;
+}
+
+void* arenaCalloc(Arena* arena, size_t count, size_t size) {
+    // Allocates zeroed memory from the arena.
+    void* memory = arenaAlloc(arena, count * size);
+    memset(memory, 0, count * size);
+    return memory;
+}
+
+void freeArena(Arena* arena) {
+    // Releases every block at once.
+    ArenaBlock* block = arena->head;
+    while (block != NULL) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
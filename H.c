@@ -0,0 +1,124 @@
+#include "pro.h"
+
+PathIndex* buildPathIndex(int* Prim, int n) {
+    // Builds depth, root and binary-lifting tables from the Prim parent array in O(n log n).
+    int levels = 1, k, v, u, top;
+    while ((1 << levels) < n)
+        levels++;
+
+    Arena* arena = makeArena(6 * ARENA_ALIGN + sizeof(PathIndex) + sizeof(int) * (size_t)n * (4 + levels));
+    PathIndex* index = (PathIndex*)arenaAlloc(arena, sizeof(PathIndex));
+    index->n = n;
+    index->levels = levels;
+    index->depth = (int*)arenaAlloc(arena, sizeof(int) * n);
+    index->root = (int*)arenaAlloc(arena, sizeof(int) * n);
+    index->up = (int*)arenaAlloc(arena, sizeof(int) * (size_t)n * levels);
+    index->scratch = (int*)arenaAlloc(arena, sizeof(int) * n);
+    index->arena = arena;
+    index->mapping = NULL;
+    index->mappingSize = 0;
+
+    // Level 0 is the parent; a root is its own ancestor so jumps saturate there.
+    for (v = 0; v < n; v++) {
+        index->up[v] = Prim[v] == -1 ? v : Prim[v];
+        index->depth[v] = -1;
+    }
+
+    // Depths: climb to the nearest node with a known depth, then unwind the chain.
+    // The scratch array serves as the explicit stack, so long chains cannot overflow.
+    for (v = 0; v < n; v++) {
+        top = 0;
+        for (u = v; index->depth[u] == -1 && Prim[u] != -1; u = Prim[u])
+            index->scratch[top++] = u;
+        if (index->depth[u] == -1) {
+            index->depth[u] = 0;
+            index->root[u] = u;
+        }
+        while (top > 0) {
+            int w = index->scratch[--top];
+            index->depth[w] = index->depth[Prim[w]] + 1;
+            index->root[w] = index->root[Prim[w]];
+        }
+    }
+
+    for (k = 1; k < levels; k++) {
+        int* prev = index->up + (size_t)(k - 1) * n;
+        int* curr = index->up + (size_t)k * n;
+        for (v = 0; v < n; v++)
+            curr[v] = prev[prev[v]];
+    }
+
+    return index;
+}
+
+int lowestCommonAncestor(PathIndex* index, int u, int v) {
+    // Returns the lowest common ancestor of u and v, or -1 if they are in different trees.
+    int k, diff, n = index->n;
+
+    if (index->root[u] != index->root[v])
+        return -1;
+
+    // Lift the deeper node to the depth of the other one.
+    if (index->depth[u] < index->depth[v]) {
+        int temp = u;
+        u = v;
+        v = temp;
+    }
+    diff = index->depth[u] - index->depth[v];
+    for (k = 0; diff > 0; k++, diff >>= 1)
+        if (diff & 1)
+            u = index->up[(size_t)k * n + u];
+
+    if (u == v)
+        return u;
+
+    // Lift both while their ancestors differ; they end one step below the LCA.
+    for (k = index->levels - 1; k >= 0; k--) {
+        int* level = index->up + (size_t)k * n;
+        if (level[u] != level[v]) {
+            u = level[u];
+            v = level[v];
+        }
+    }
+
+    return index->up[u];
+}
+
+void printIndexedPath(PathIndex* index, int first, int last) {
+    // Prints the tree path first -> last in O(log n + path length).
+    int lca, v, count = 0;
+
+    if (first >= index->n || first < 0 || last >= index->n || last < 0) {
+        printf("invalid input");
+        exit(1);
+    }
+    STAT_ADD(pathQueries, 1);
+
+    lca = lowestCommonAncestor(index, first, last);
+    if (lca == -1) {
+        printf("NO PATH\n");
+        return;
+    }
+
+    // Upward half: first, its parent, ..., the LCA.
+    for (v = first; v != lca; v = index->up[v]) {
+        STAT_ADD(indexedPathSteps, 1);
+        printf("%d ", v);
+    }
+    printf("%d ", lca);
+
+    // Downward half: collect last .. (below the LCA) and print it reversed.
+    for (v = last; v != lca; v = index->up[v]) {
+        STAT_ADD(indexedPathSteps, 1);
+        index->scratch[count++] = v;
+    }
+    while (count > 0)
+        printf("%d ", index->scratch[--count]);
+}
+
+void freePathIndex(PathIndex* index) {
+    // The index struct and its tables live in one arena, or partly in a cache file mapping.
+    if (index->mapping != NULL)
+        unmapFile(index->mapping, index->mappingSize);
+    freeArena(index->arena);
+}
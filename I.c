@@ -0,0 +1,217 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // Exposes sysconf() under strict ISO C modes.
+#endif
+#include "pro.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// Arguments of one worker thread started by runParallel.
+typedef struct {
+    ParallelTask task;
+    void* arg;
+    int id;
+} WorkerStart;
+
+// Generation barrier: the last worker to arrive runs the serial step, starts a new
+// generation and wakes the others, which wait for the generation they arrived in to end.
+struct Barrier {
+#ifdef _WIN32
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE released;
+#else
+    pthread_mutex_t lock;
+    pthread_cond_t released;
+#endif
+    int workers;
+    int waiting;
+    unsigned int generation;
+};
+
+#ifdef _WIN32
+static unsigned __stdcall workerMain(void* start) {
+    WorkerStart* w = (WorkerStart*)start;
+    w->task(w->arg, w->id);
+    return 0;
+}
+#else
+static void* workerMain(void* start) {
+    WorkerStart* w = (WorkerStart*)start;
+    w->task(w->arg, w->id);
+    return NULL;
+}
+#endif
+
+int cpuCount(void) {
+    // Number of online processors, at least 1.
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+void runParallel(int workers, ParallelTask task, void* arg) {
+    // Fork-join: runs task(arg, id) for id = 0 .. workers - 1, worker 0 on the calling thread.
+    int i;
+    if (workers <= 1) {
+        task(arg, 0);
+        return;
+    }
+
+    WorkerStart* starts = (WorkerStart*)allocOrExit(sizeof(WorkerStart) * workers);
+#ifdef _WIN32
+    HANDLE* threads = (HANDLE*)allocOrExit(sizeof(HANDLE) * workers);
+#else
+    pthread_t* threads = (pthread_t*)allocOrExit(sizeof(pthread_t) * workers);
+#endif
+
+    for (i = 1; i < workers; i++) {
+        starts[i].task = task;
+        starts[i].arg = arg;
+        starts[i].id = i;
+#ifdef _WIN32
+        threads[i] = (HANDLE)_beginthreadex(NULL, 0, workerMain, &starts[i], 0, NULL);
+        if (threads[i] == 0) {
+#else
+        if (pthread_create(&threads[i], NULL, workerMain, &starts[i]) != 0) {
+#endif
+            printf("thread error");
+            exit(1);
+        }
+    }
+
+    task(arg, 0);
+
+    for (i = 1; i < workers; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+
+    free(threads);
+    free(starts);
+}
+
+
+int atomicFetchAdd(volatile int* value, int delta) {
+    // Atomically adds `delta` and returns the previous value.
+#ifdef _WIN32
+    return (int)InterlockedExchangeAdd((volatile long*)value, delta);
+#else
+    return __atomic_fetch_add(value, delta, __ATOMIC_SEQ_CST);
+#endif
+}
+
+long long atomicFetchAdd64(volatile long long* value, long long delta) {
+    // 64-bit counterpart of atomicFetchAdd, used by the instrumentation counters.
+#ifdef _WIN32
+    return (long long)InterlockedExchangeAdd64(value, delta);
+#else
+    return __atomic_fetch_add(value, delta, __ATOMIC_SEQ_CST);
+#endif
+}
+
+int atomicLoad(volatile int* value) {
+    // Reads a value that other workers may be updating with atomicCompareExchange.
+#ifdef _WIN32
+    return (int)InterlockedCompareExchange((volatile long*)value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+bool atomicCompareExchange(volatile int* value, int* expected, int desired) {
+    // Stores `desired` if the value still equals *expected; otherwise loads the current value
+    // into *expected and returns false.
+#ifdef _WIN32
+    int previous = (int)InterlockedCompareExchange((volatile long*)value, desired, *expected);
+    if (previous == *expected)
+        return true;
+    *expected = previous;
+    return false;
+#else
+    return __atomic_compare_exchange_n(value, expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+Barrier* makeBarrier(int workers) {
+    // One mutex and condition variable; nothing is allocated per wait.
+    Barrier* barrier = (Barrier*)allocOrExit(sizeof(Barrier));
+    barrier->workers = workers;
+    barrier->waiting = 0;
+    barrier->generation = 0;
+#ifdef _WIN32
+    InitializeCriticalSection(&barrier->lock);
+    InitializeConditionVariable(&barrier->released);
+#else
+    if (pthread_mutex_init(&barrier->lock, NULL) != 0 || pthread_cond_init(&barrier->released, NULL) != 0) {
+        printf("thread error");
+        exit(1);
+    }
+#endif
+    return barrier;
+}
+
+void waitBarrier(Barrier* barrier, SerialStep step, void* arg) {
+    // Blocks until all workers have arrived. The step runs under the lock, so every worker
+    // sees its writes when it is released.
+    unsigned int generation;
+
+    if (barrier->workers <= 1) {
+        if (step != NULL)
+            step(arg);
+        return;
+    }
+#ifdef _WIN32
+    EnterCriticalSection(&barrier->lock);
+#else
+    pthread_mutex_lock(&barrier->lock);
+#endif
+    generation = barrier->generation;
+    if (++barrier->waiting == barrier->workers) {
+        if (step != NULL)
+            step(arg);
+        barrier->waiting = 0;
+        barrier->generation++;
+#ifdef _WIN32
+        WakeAllConditionVariable(&barrier->released);
+#else
+        pthread_cond_broadcast(&barrier->released);
+#endif
+    }
+    while (generation == barrier->generation) {
+#ifdef _WIN32
+        SleepConditionVariableCS(&barrier->released, &barrier->lock, INFINITE);
+#else
+        pthread_cond_wait(&barrier->released, &barrier->lock);
+#endif
+    }
+#ifdef _WIN32
+    LeaveCriticalSection(&barrier->lock);
+#else
+    pthread_mutex_unlock(&barrier->lock);
+#endif
+}
+
+void freeBarrier(Barrier* barrier) {
+    // Called after runParallel has joined every worker that used the barrier.
+#ifdef _WIN32
+    DeleteCriticalSection(&barrier->lock);
+#else
+    pthread_mutex_destroy(&barrier->lock);
+    pthread_cond_destroy(&barrier->released);
+#endif
+    free(barrier);
+}
@@ -0,0 +1,238 @@
+#include "pro.h"
+
+int* build_boruvka_tree(Graph* Net, int threads) {
+    // Boruvka's algorithm: every round each component picks its cheapest outgoing edge
+    // and all picks are merged. Every step of a round runs on `threads` workers: the edge
+    // scan, the per-component pick (compare-and-swap), hooking the components together
+    // and the pointer jumping that relabels them. The workers are started once per build
+    // and wait at a barrier between steps.
+    int n = Net->n, v;
+    BoruvkaRound round;
+    int* prim;
+
+    Arena* workspace = makeArena(ARENA_DEFAULT_BLOCK);
+    round.graph = Net;
+    round.parent = (int*)arenaAlloc(workspace, sizeof(int) * n);
+    round.jumped = (int*)arenaAlloc(workspace, sizeof(int) * n);
+    round.label = (int*)arenaAlloc(workspace, sizeof(int) * n);
+    round.bestEdge = (int*)arenaAlloc(workspace, sizeof(int) * n);
+    round.compFrom = (volatile int*)arenaAlloc(workspace, sizeof(int) * n);
+    round.tree = (InputEdge*)arenaAlloc(workspace, sizeof(InputEdge) * n);
+    round.count = 0;
+    round.workers = threads > 1 ? threads : 1;
+    round.split = (int*)arenaAlloc(workspace, sizeof(int) * (round.workers + 1));
+    splitByEdges(Net, round.split, round.workers);
+    round.barrier = makeBarrier(round.workers);
+
+    for (v = 0; v < n; v++) {
+        round.parent[v] = v;
+        round.label[v] = v;
+        round.compFrom[v] = -1;
+    }
+
+    round.added = round.changed = 0;
+    runParallel(round.workers, boruvkaWorker, &round);
+    freeBarrier(round.barrier);
+
+    if (n > 0 && round.count != n - 1) {
+        printf("Cannot build Prim"); // Not every node is reachable, so no spanning tree exists.
+        exit(1);
+    }
+
+    // The tree edges arrive in no fixed order, but a rooted tree has only one parent array.
+    prim = treeToPrim(round.tree, round.count, n);
+    freeArena(workspace);
+    return prim;
+}
+
+void splitByEdges(Graph* Net, int* split, int workers) {
+    // Gives every worker a node range holding about m / workers edges, so hubs don't serialize a round.
+    int i, v = 0;
+
+    split[0] = 0;
+    for (i = 1; i < workers; i++) {
+        long long target = (long long)Net->m * i / workers;
+        while (v < Net->n && Net->offsets[v] < target)
+            v++;
+        split[i] = v;
+    }
+    split[workers] = Net->n;
+}
+
+bool mstEdgeLess(Graph* Net, int u1, int j1, int u2, int j2) {
+    // Total edge order: cost, then lower endpoint, then higher endpoint.
+    int w1 = Net->neighbors[j1], w2 = Net->neighbors[j2];
+    int lo1 = u1 < w1 ? u1 : w1, hi1 = u1 < w1 ? w1 : u1;
+    int lo2 = u2 < w2 ? u2 : w2, hi2 = u2 < w2 ? w2 : u2;
+
+    if (Net->costs[j1] != Net->costs[j2])
+        return Net->costs[j1] < Net->costs[j2];
+    if (lo1 != lo2)
+        return lo1 < lo2;
+    return hi1 < hi2;
+}
+
+void boruvkaWorker(void* arg, int id) {
+    // Worker: every round of the build. The barrier ends each step once all workers are
+    // through it, and its serial steps update the shared state the next step reads.
+    BoruvkaRound* round = (BoruvkaRound*)arg;
+
+    while (true) {
+        boruvkaScan(round, id);
+        waitBarrier(round->barrier, NULL, NULL);
+        boruvkaPick(round, id);
+        waitBarrier(round->barrier, NULL, NULL);
+        boruvkaHook(round, id);
+        waitBarrier(round->barrier, boruvkaHooked, round);
+        if (round->done)
+            return;
+
+        // Hooks form trees of component roots; halve their depth until every node points at its root.
+        do {
+            boruvkaJump(round, id);
+            waitBarrier(round->barrier, boruvkaJumped, round);
+        } while (round->jumping);
+        boruvkaRelabel(round, id);
+        waitBarrier(round->barrier, NULL, NULL);
+    }
+}
+
+void boruvkaScan(void* arg, int id) {
+    // Worker: for every node in its range, the cheapest edge to another component (or -1).
+    BoruvkaRound* round = (BoruvkaRound*)arg;
+    Graph* Net = round->graph;
+    int v, j, best;
+
+    for (v = round->split[id]; v < round->split[id + 1]; v++) {
+        best = -1;
+        for (j = Net->offsets[v]; j < Net->offsets[v + 1]; j++) {
+            if (round->label[Net->neighbors[j]] == round->label[v])
+                continue; // Internal edge.
+            if (best == -1 || mstEdgeLess(Net, v, j, v, best))
+                best = j;
+        }
+        round->bestEdge[v] = best;
+    }
+}
+
+void boruvkaPick(void* arg, int id) {
+    // Worker: offers the pick of every node in its range to the node's component. A pick
+    // replaces the current one only if it is cheaper in the total order, so after all
+    // workers finish compFrom[c] is the node with the cheapest edge leaving component c.
+    BoruvkaRound* round = (BoruvkaRound*)arg;
+    Graph* Net = round->graph;
+    int v, current;
+
+    for (v = round->split[id]; v < round->split[id + 1]; v++) {
+        int j = round->bestEdge[v];
+        if (j == -1)
+            continue;
+        volatile int* pick = &round->compFrom[round->label[v]];
+        current = atomicLoad(pick);
+        while (current == -1 || mstEdgeLess(Net, v, j, current, round->bestEdge[current])) {
+            if (atomicCompareExchange(pick, &current, v))
+                break;
+        }
+    }
+}
+
+void boruvkaHook(void* arg, int id) {
+    // Worker: hooks every component root c of its range under the component its pick leads to.
+    // The edge order is total, so the picks form no cycle except two components picking the
+    // same edge; there the lower root stays a root and the other one records the edge.
+    BoruvkaRound* round = (BoruvkaRound*)arg;
+    Graph* Net = round->graph;
+    int c, added = 0;
+
+    for (c = round->split[id]; c < round->split[id + 1]; c++) {
+        int u = round->compFrom[c];
+        if (u == -1)
+            continue;
+        int j = round->bestEdge[u], w = Net->neighbors[j], d = round->label[w];
+        int back = round->compFrom[d];
+        if (back != -1 && round->label[Net->neighbors[round->bestEdge[back]]] == c && c < d)
+            continue; // Mutual pick: d hooks under c.
+
+        round->parent[c] = d; // Only this worker writes parent[c] in this step.
+        int slot = atomicFetchAdd(&round->count, 1);
+        round->tree[slot].a = u < w ? u : w;
+        round->tree[slot].b = u < w ? w : u;
+        round->tree[slot].cost = Net->costs[j];
+        added++;
+    }
+    if (added > 0)
+        atomicFetchAdd(&round->added, added);
+}
+
+void boruvkaJump(void* arg, int id) {
+    // Worker: one pointer-jumping step, jumped[v] = parent[parent[v]], reading only `parent`.
+    BoruvkaRound* round = (BoruvkaRound*)arg;
+    int v, changed = 0;
+
+    for (v = round->split[id]; v < round->split[id + 1]; v++) {
+        int up = round->parent[round->parent[v]];
+        round->jumped[v] = up;
+        if (up != round->parent[v])
+            changed = 1;
+    }
+    if (changed)
+        atomicFetchAdd(&round->changed, 1);
+}
+
+void boruvkaRelabel(void* arg, int id) {
+    // Worker: after the jumps every node points at its component root, which becomes its
+    // label; the picks are cleared for the next round.
+    BoruvkaRound* round = (BoruvkaRound*)arg;
+    int v;
+
+    for (v = round->split[id]; v < round->split[id + 1]; v++) {
+        round->label[v] = round->parent[v];
+        round->compFrom[v] = -1;
+    }
+}
+
+void boruvkaHooked(void* arg) {
+    // Serial step after the hooks: a round without new edges ends the build.
+    BoruvkaRound* round = (BoruvkaRound*)arg;
+
+    round->done = round->added == 0;
+    round->added = 0;
+}
+
+void boruvkaJumped(void* arg) {
+    // Serial step after a jump: the jumped pointers become the forest of the next step.
+    BoruvkaRound* round = (BoruvkaRound*)arg;
+    int* swap = round->parent;
+
+    round->parent = round->jumped;
+    round->jumped = swap;
+    round->jumping = round->changed > 0;
+    round->changed = 0;
+}
+
+int findSet(int* parent, int v) {
+    // Finds the root of v's set, halving the path on the way.
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+bool unionSets(int* parent, int* rank, int u, int w) {
+    // Union by rank; returns false if u and w were already in the same set.
+    u = findSet(parent, u);
+    w = findSet(parent, w);
+    if (u == w)
+        return false;
+
+    if (rank[u] < rank[w]) {
+        int temp = u;
+        u = w;
+        w = temp;
+    }
+    parent[w] = u;
+    if (rank[u] == rank[w])
+        rank[u]++;
+    return true;
+}
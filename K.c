@@ -0,0 +1,93 @@
+#include "pro.h"
+
+int* build_kruskal_tree(Graph* Net) {
+    // Kruskal's algorithm: scan the edges by increasing cost and keep every edge that joins
+    // two different components of a union-find forest.
+    int n = Net->n, count = 0, total, i, v;
+    int* prim;
+
+    Arena* workspace = makeArena(ARENA_DEFAULT_BLOCK);
+    InputEdge* edges = collectEdges(workspace, Net, &total);
+    int* parent = (int*)arenaAlloc(workspace, sizeof(int) * n);
+    int* rank = (int*)arenaCalloc(workspace, n, sizeof(int));
+    InputEdge* tree = (InputEdge*)arenaAlloc(workspace, sizeof(InputEdge) * n);
+
+    // Edges come out of the CSR in (low, high) order; the stable sort keeps that order
+    // among equal costs, which is the same tie-break Boruvka uses.
+    radixSortByCost(workspace, edges, total);
+
+    for (v = 0; v < n; v++)
+        parent[v] = v;
+
+    for (i = 0; i < total && count < n - 1; i++)
+        if (unionSets(parent, rank, edges[i].a, edges[i].b))
+            tree[count++] = edges[i];
+
+    if (n > 0 && count != n - 1) {
+        printf("Cannot build Prim"); // Not every node is reachable, so no spanning tree exists.
+        exit(1);
+    }
+
+    prim = treeToPrim(tree, count, n);
+    freeArena(workspace);
+    return prim;
+}
+
+InputEdge* collectEdges(Arena* arena, Graph* Net, int* count) {
+    // Lists every connection once, as (low, high, cost), in ascending (low, high) order.
+    InputEdge* edges = (InputEdge*)arenaAlloc(arena, sizeof(InputEdge) * (Net->m / 2));
+    int v, j, total = 0;
+
+    for (v = 0; v < Net->n; v++) {
+        for (j = Net->offsets[v]; j < Net->offsets[v + 1]; j++) {
+            if (Net->neighbors[j] > v) {
+                edges[total].a = v;
+                edges[total].b = Net->neighbors[j];
+                edges[total++].cost = Net->costs[j];
+            }
+        }
+    }
+
+    *count = total;
+    return edges;
+}
+
+void radixSortByCost(Arena* scratch, InputEdge* edges, int m) {
+    // Stable LSD radix sort on the (non-negative) cost in 11-bit digits; a digit that is
+    // the same for every edge is skipped, so small cost ranges take a single pass.
+    InputEdge* temp = (InputEdge*)arenaAlloc(scratch, sizeof(InputEdge) * m);
+    int* count = (int*)arenaAlloc(scratch, sizeof(int) * (RADIX_BUCKETS + 1));
+    InputEdge* from = edges, * to = temp, * swap;
+    int shift, i, maxCost = 0;
+
+    for (i = 0; i < m; i++)
+        if (edges[i].cost > maxCost)
+            maxCost = edges[i].cost;
+
+    for (shift = 0; shift < 31 && (maxCost >> shift) > 0; shift += RADIX_BITS) {
+        memset(count, 0, sizeof(int) * (RADIX_BUCKETS + 1));
+        for (i = 0; i < m; i++)
+            count[((from[i].cost >> shift) & (RADIX_BUCKETS - 1)) + 1]++;
+        if (count[((from[0].cost >> shift) & (RADIX_BUCKETS - 1)) + 1] == m)
+            continue; // Every edge has the same digit: nothing to reorder.
+        for (i = 0; i < RADIX_BUCKETS; i++)
+            count[i + 1] += count[i];
+        for (i = 0; i < m; i++)
+            to[count[(from[i].cost >> shift) & (RADIX_BUCKETS - 1)]++] = from[i];
+        swap = from;
+        from = to;
+        to = swap;
+    }
+
+    if (from != edges)
+        memcpy(edges, from, sizeof(InputEdge) * m);
+}
+
+MstEngine chooseEngine(Graph* Net) {
+    // Very sparse graphs (E up to KRUSKAL_MAX_DENSITY * V) spend Prim's heap traffic for
+    // nothing: sorting the few edges and a union-find pass is cheaper. Otherwise use Prim.
+    long long edges = Net->m / 2;
+    if (edges <= (long long)KRUSKAL_MAX_DENSITY * Net->n)
+        return ENGINE_KRUSKAL;
+    return ENGINE_PRIM;
+}
@@ -0,0 +1,113 @@
+#include "pro.h"
+
+Components* labelComponents(Arena* arena, Graph* Net) {
+    // Labels connected components with one BFS sweep in O(V + E). Components are numbered
+    // in order of their smallest node, which is also their root.
+    int n = Net->n, v, c, head, tail, u, j;
+    Components* comps = (Components*)arenaAlloc(arena, sizeof(Components));
+    int* queue = (int*)arenaAlloc(arena, sizeof(int) * n);
+
+    comps->label = (int*)arenaAlloc(arena, sizeof(int) * n);
+    comps->root = (int*)arenaAlloc(arena, sizeof(int) * n);
+    comps->start = (int*)arenaAlloc(arena, sizeof(int) * ((size_t)n + 1));
+    comps->count = 0;
+
+    for (v = 0; v < n; v++)
+        comps->label[v] = -1;
+
+    // The BFS queue visits each component contiguously, so its start is the prefix sum of sizes.
+    tail = 0;
+    for (v = 0; v < n; v++) {
+        if (comps->label[v] != -1)
+            continue;
+        c = comps->count++;
+        comps->root[c] = v;
+        comps->start[c] = tail;
+        comps->label[v] = c;
+        head = tail;
+        queue[tail++] = v;
+        while (head < tail) {
+            u = queue[head++];
+            for (j = Net->offsets[u]; j < Net->offsets[u + 1]; j++) {
+                if (comps->label[Net->neighbors[j]] == -1) {
+                    comps->label[Net->neighbors[j]] = c;
+                    queue[tail++] = Net->neighbors[j];
+                }
+            }
+        }
+    }
+    comps->start[comps->count] = tail;
+
+    return comps;
+}
+
+int* build_prim_forest(Graph* Net, int threads) {
+    // Minimum spanning forest: one Prim tree per connected component, the components handed
+    // out to `threads` workers. Every component root keeps -1 in the returned array.
+    int n = Net->n, v;
+    ForestBuild build;
+    int* prim;
+
+    Arena* workspace = makeArena(ARENA_DEFAULT_BLOCK);
+    build.graph = Net;
+    build.comps = labelComponents(workspace, Net);
+    build.prim = prim = buildPrim(n);
+    build.minArr = buildMinArr(workspace, n);
+    build.inT = buildIntList(workspace, n);
+    build.location = (int*)arenaAlloc(workspace, sizeof(int) * n);
+    build.slots = (Candidate*)arenaAlloc(workspace, sizeof(Candidate) * n);
+    build.next = 0;
+
+    for (v = 0; v < n; v++)
+        build.location[v] = -1; // Not in any heap yet.
+
+    // Components are disjoint, so workers share the per-node arrays without conflicts.
+    if (threads > build.comps->count)
+        threads = build.comps->count;
+    runParallel(threads, forestWorker, &build);
+
+    freeArena(workspace);
+    return prim;
+}
+
+void forestWorker(void* arg, int id) {
+    // Worker: claims components one at a time until none are left.
+    ForestBuild* build = (ForestBuild*)arg;
+    int c;
+    (void)id;
+
+    while ((c = atomicFetchAdd(&build->next, 1)) < build->comps->count)
+        primComponent(build, c);
+}
+
+void primComponent(ForestBuild* build, int c) {
+    // Prim's Algorithm on component `c`. Its heap lives in the component's own slice of
+    // `slots` (sized to the component) and nodes enter it when they are first reached.
+    Graph* Net = build->graph;
+    CandidateHeap heap;
+    int root = build->comps->root[c], u, v, j;
+
+    heap.heap = build->slots + build->comps->start[c];
+    heap.location = build->location;
+    heap.size = 0;
+
+    build->minArr[root] = 0;
+    insertCandidate(&heap, root, 0);
+
+    while (heap.size > 0) {
+        u = deleteMin(&heap);
+        build->inT[u] = true;
+
+        for (j = Net->offsets[u]; j < Net->offsets[u + 1]; j++) {
+            v = Net->neighbors[j];
+            if (!build->inT[v] && Net->costs[j] < build->minArr[v]) {
+                build->minArr[v] = Net->costs[j];
+                build->prim[v] = u;
+                if (build->location[v] == -1)
+                    insertCandidate(&heap, v, Net->costs[j]);
+                else
+                    decreaseKey(&heap, v, Net->costs[j]);
+            }
+        }
+    }
+}
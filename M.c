@@ -0,0 +1,143 @@
+#include "pro.h"
+
+DynamicMst* makeDynamicMst(Graph* Net, int* Prim) {
+    // Wraps an existing `Prim` array (patched in place by updates) and records the cost
+    // of every tree edge, looked up in the network in O(log degree).
+    int n = Net->n, v;
+    Arena* arena = makeArena(4 * ARENA_ALIGN + sizeof(DynamicMst) + (size_t)n * 3 * sizeof(int));
+    DynamicMst* dyn = (DynamicMst*)arenaAlloc(arena, sizeof(DynamicMst));
+
+    dyn->n = n;
+    dyn->parent = Prim;
+    dyn->cost = (int*)arenaAlloc(arena, sizeof(int) * n);
+    dyn->stamp = (unsigned int*)arenaCalloc(arena, n, sizeof(unsigned int));
+    dyn->side = (int*)arenaAlloc(arena, sizeof(int) * n);
+    dyn->epoch = 0;
+    dyn->arena = arena;
+
+    for (v = 0; v < n; v++)
+        dyn->cost[v] = Prim[v] == -1 ? 0 : findEdgeCost(Net, v, Prim[v]);
+
+    return dyn;
+}
+
+void freeDynamicMst(DynamicMst* dyn) {
+    // The `Prim` array belongs to the caller; everything else lives in the arena.
+    freeArena(dyn->arena);
+}
+
+bool markWalk(DynamicMst* dyn, int v, int side) {
+    // Stamps `v` as reached from `side`; returns true if the other walk reached it first.
+    if (dyn->stamp[v] == dyn->epoch && dyn->side[v] != side)
+        return true;
+    dyn->stamp[v] = dyn->epoch;
+    dyn->side[v] = side;
+    return false;
+}
+
+int dynamicLca(DynamicMst* dyn, int a, int b) {
+    // Climbs from a and b in turn until one walk steps on a node of the other. The first
+    // such node is the LCA, found in O(path length) without depths; -1 across trees.
+    int x = a, y = b;
+
+    if (++dyn->epoch == 0) {
+        memset(dyn->stamp, 0, sizeof(unsigned int) * dyn->n); // Wrapped around; clear once.
+        dyn->epoch = 1;
+    }
+    if (a == b)
+        return a;
+    markWalk(dyn, a, 0);
+    if (markWalk(dyn, b, 1))
+        return b;
+
+    while (x != -1 || y != -1) {
+        if (x != -1 && (x = dyn->parent[x]) != -1 && markWalk(dyn, x, 0))
+            return x;
+        if (y != -1 && (y = dyn->parent[y]) != -1 && markWalk(dyn, y, 1))
+            return y;
+    }
+
+    return -1;
+}
+
+void evertPath(DynamicMst* dyn, int v, int stop) {
+    // Reverses the parent pointers on the path v -> stop (an ancestor of v), moving each
+    // edge cost along. Afterwards v has no parent and stop's old parent edge is dropped.
+    int prev = -1, prevCost = 0, cur = v, next, nextCost;
+
+    for (;;) {
+        next = dyn->parent[cur];
+        nextCost = dyn->cost[cur];
+        dyn->parent[cur] = prev;
+        dyn->cost[cur] = prevCost;
+        if (cur == stop)
+            break;
+        prev = cur;
+        prevCost = nextCost;
+        cur = next;
+    }
+}
+
+int maxEdgeBelow(DynamicMst* dyn, int v, int lca) {
+    // Node whose parent edge is the most expensive on the path v -> lca, or -1 if v == lca.
+    int best = -1;
+
+    for (; v != lca; v = dyn->parent[v])
+        if (best == -1 || dyn->cost[v] > dyn->cost[best])
+            best = v;
+
+    return best;
+}
+
+bool updateMst(DynamicMst* dyn, int a, int b, int cost) {
+    // Applies a new or cheaper edge (a, b, cost). By the cycle property the MST only changes
+    // if the edge is cheaper than the most expensive edge on the tree path a - b; that
+    // edge is then swapped out. Returns true if the tree changed. Costs O(path length).
+    int lca, maxA, maxB, cut, near;
+
+    if (a >= dyn->n || a < 0 || b >= dyn->n || b < 0 || cost < 0 || a == b) {
+        printf("invalid input");
+        exit(1);
+    }
+
+    // An edge already in the tree just gets cheaper.
+    if (dyn->parent[a] == b || dyn->parent[b] == a) {
+        int child = dyn->parent[a] == b ? a : b;
+        if (cost >= dyn->cost[child])
+            return false;
+        dyn->cost[child] = cost;
+        return true;
+    }
+
+    lca = dynamicLca(dyn, a, b);
+    if (lca == -1) {
+        // Different trees of a forest: the edge joins them. Make b the root of its tree.
+        int root = b;
+        while (dyn->parent[root] != -1)
+            root = dyn->parent[root];
+        evertPath(dyn, b, root);
+        dyn->parent[b] = a;
+        dyn->cost[b] = cost;
+        return true;
+    }
+
+    maxA = maxEdgeBelow(dyn, a, lca);
+    maxB = maxEdgeBelow(dyn, b, lca);
+    if (maxB != -1 && (maxA == -1 || dyn->cost[maxB] > dyn->cost[maxA])) {
+        cut = maxB;
+        near = b;
+    }
+    else {
+        cut = maxA;
+        near = a;
+    }
+    if (cost >= dyn->cost[cut])
+        return false; // Ties keep the current tree.
+
+    // Cutting (cut, parent[cut]) detaches the subtree holding `near`; re-hang it from the
+    // other endpoint through the new edge.
+    evertPath(dyn, near, cut);
+    dyn->parent[near] = near == a ? b : a;
+    dyn->cost[near] = cost;
+    return true;
+}
@@ -0,0 +1,306 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // Exposes dup(), fdopen() and clock_gettime() under strict ISO C modes.
+#endif
+#include "pro.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#include <psapi.h>
+#define NULL_DEVICE "NUL"
+#define dup _dup
+#define fdopen _fdopen
+#else
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
+double nowSeconds(void) {
+    // Monotonic wall clock in seconds.
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+long peakRssKb(void) {
+    // Peak resident set size of the process so far, in KiB.
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return (long)(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // Bytes on macOS.
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+unsigned long long nextRandom(unsigned long long* state) {
+    // splitmix64: the same seed gives the same graph on every platform.
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+int randomBelow(unsigned long long* state, int bound) {
+    // Uniform-enough integer in [0, bound) for benchmark graphs.
+    return (int)(nextRandom(state) % (unsigned long long)bound);
+}
+
+void addBenchEdge(InputEdge* edges, int* count, int a, int b, unsigned long long* state) {
+    // Appends the connection a - b under its (low, high) key with a random cost.
+    edges[*count].a = a < b ? a : b;
+    edges[*count].b = a < b ? b : a;
+    edges[*count].cost = randomBelow(state, BENCH_MAX_COST + 1);
+    (*count)++;
+}
+
+InputEdge* generateGraph(Arena* arena, BenchConfig* config, int* count) {
+    // Builds the connections of a synthetic graph. Every kind is connected, and repeated
+    // connections are removed so build_net sees a clean edge list.
+    int n = config->nodes, degree = config->degree, i, j, side, links;
+    unsigned long long state = config->seed;
+    long long capacity = (long long)n * (degree > 4 ? degree : 4) + 1;
+    InputEdge* edges = (InputEdge*)arenaAlloc(arena, sizeof(InputEdge) * capacity);
+    int* targets;
+    int total = 0, picks = 0;
+
+    switch (config->kind) {
+    case GRAPH_CHAIN:
+        for (i = 1; i < n; i++)
+            addBenchEdge(edges, &total, i - 1, i, &state);
+        break;
+
+    case GRAPH_GRID:
+        // Near-square lattice, each node linked to its right and lower neighbors.
+        for (side = 1; (long long)side * side < n; side++)
+            ;
+        for (i = 0; i < n; i++) {
+            if (i % side + 1 < side && i + 1 < n)
+                addBenchEdge(edges, &total, i, i + 1, &state);
+            if (i + side < n)
+                addBenchEdge(edges, &total, i, i + side, &state);
+        }
+        break;
+
+    case GRAPH_POWERLAW:
+        // Preferential attachment: endpoints are drawn from the list of all previous
+        // endpoints, so a node is picked in proportion to its degree.
+        links = degree / 2 > 0 ? degree / 2 : 1;
+        targets = (int*)arenaAlloc(arena, sizeof(int) * (2 * capacity));
+        for (i = 1; i < n; i++) {
+            for (j = 0; j < links && j < i; j++) {
+                int t = j == 0 || picks == 0 ? randomBelow(&state, i) : targets[randomBelow(&state, picks)];
+                if (t == i)
+                    continue; // The node's own earlier picks are in the list too.
+                addBenchEdge(edges, &total, i, t, &state);
+                targets[picks++] = i;
+                targets[picks++] = t;
+            }
+        }
+        break;
+
+    default:
+        // Random tree for connectivity, then uniformly random extra connections.
+        for (i = 1; i < n; i++)
+            addBenchEdge(edges, &total, i, randomBelow(&state, i), &state);
+        for (long long extra = (long long)n * degree / 2 - (n - 1); extra > 0 && n > 1; extra--) {
+            int a = randomBelow(&state, n), b = randomBelow(&state, n);
+            if (a != b)
+                addBenchEdge(edges, &total, a, b, &state);
+        }
+        break;
+    }
+
+    if (config->shuffle) {
+        // Random node ids, like input whose numbering carries no locality.
+        int* label = (int*)arenaAlloc(arena, sizeof(int) * n);
+        for (i = 0; i < n; i++)
+            label[i] = i;
+        for (i = n - 1; i > 0; i--) {
+            j = randomBelow(&state, i + 1);
+            int swap = label[i];
+            label[i] = label[j];
+            label[j] = swap;
+        }
+        for (i = 0; i < total; i++) {
+            int a = label[edges[i].a], b = label[edges[i].b];
+            edges[i].a = a < b ? a : b;
+            edges[i].b = a < b ? b : a;
+        }
+    }
+
+    radixSortEdges(arena, edges, total, n);
+    *count = dedupeEdges(edges, total);
+    return edges;
+}
+
+void writeBenchInput(FILE* file, InputEdge* edges, int count, int n) {
+    // Writes the graph in the program's text input format.
+    int i;
+    fprintf(file, "%d\n%d\n", n, count);
+    for (i = 0; i < count; i++)
+        fprintf(file, "%d %d %d\n", edges[i].a, edges[i].b, edges[i].cost);
+    fflush(file);
+}
+
+void reportPhase(FILE* out, const char* phase, double seconds, long long items, const char* unit, bool last) {
+    // One JSON phase record: wall time, peak RSS so far and throughput.
+    fprintf(out, "{\"phase\":\"%s\",\"seconds\":%.6f,\"peak_rss_kb\":%ld,\"%s\":%lld,\"%s_per_second\":%.1f}%s",
+        phase, seconds, peakRssKb(), unit, items, unit, seconds > 0 ? items / seconds : 0.0, last ? "" : ",");
+}
+
+int runBenchmark(BenchConfig* config) {
+    // Generates the configured graph, runs every phase of the program on it and writes one
+    // JSON line with per-phase results to stdout. The phases' own output goes to the null device.
+    const char* kinds[] = { "random", "grid", "powerlaw", "chain" };
+    const char* orders[] = { "none", "bfs", "rcm", "degree" };
+    int n = config->nodes, count, q, i;
+    unsigned long long state = config->seed ^ 0x5DEECE66Dull;
+    double start;
+
+    FILE* out = fdopen(dup(fileno(stdout)), "w");
+    if (out == NULL || freopen(NULL_DEVICE, "w", stdout) == NULL) {
+        fprintf(stderr, "cannot redirect output");
+        return 1;
+    }
+
+    Arena* scratch = makeArena(ARENA_DEFAULT_BLOCK);
+    InputEdge* edges = generateGraph(scratch, config, &count);
+    FILE* input = tmpfile();
+    if (input == NULL) {
+        fprintf(stderr, "cannot create a temporary file");
+        return 1;
+    }
+    writeBenchInput(input, edges, count, n);
+    rewind(input);
+    freeArena(scratch);
+
+    fprintf(out, "{\"graph\":\"%s\",\"nodes\":%d,\"edges\":%d,\"seed\":%llu,\"engine\":\"%s\",\"forest\":%s,"
+        "\"compressed\":%s,\"shuffle\":%s,\"reorder\":\"%s\",\"threads\":%d,\"queries\":%d,\"phases\":[",
+        kinds[config->kind], n, count, config->seed, engineName(config->engine),
+        config->forest ? "true" : "false", config->compressed ? "true" : "false",
+        config->shuffle ? "true" : "false", orders[config->reorder], config->threads, config->queries);
+
+    // build_net: parse the text input and build the CSR network.
+    Reader* in = openReader(input);
+    start = nowSeconds();
+    readInt(in, &i);
+    Graph* Net = build_net(in, n);
+    reportPhase(out, "build_net", nowSeconds() - start, count, "edges", false);
+    closeReader(in);
+    fclose(input);
+
+    // With --reorder, the MST phase runs on the relabeled network.
+    int* newId = NULL;
+    if (config->reorder != REORDER_NONE) {
+        start = nowSeconds();
+        newId = computeOrder(Net, config->reorder);
+        Graph* Reordered = permuteGraph(Net, newId);
+        freeGraph(Net);
+        Net = Reordered;
+        reportPhase(out, "reorder", nowSeconds() - start, count, "edges", false);
+    }
+
+    // With --compressed, Prim and the path search run on the packed edge lists.
+    int* Prim;
+    size_t adjacencyBytes = sizeof(int) * ((size_t)n + 1 + 2 * (size_t)Net->m);
+    CompressedGraph* Packed = NULL;
+    CompressedGraph* PackedPath = NULL;
+    if (config->compressed) {
+        start = nowSeconds();
+        Packed = compressGraph(Net);
+        reportPhase(out, "compress", nowSeconds() - start, count, "edges", false);
+        adjacencyBytes = sizeof(size_t) * ((size_t)n + 1) + Packed->offsets[n];
+        start = nowSeconds();
+        Prim = build_compressed_prim_tree(Packed);
+    }
+    else {
+        start = nowSeconds();
+        Prim = config->forest ? build_prim_forest(Net, config->threads) : build_mst(Net, config->engine, config->threads);
+    }
+    reportPhase(out, "build_mst", nowSeconds() - start, count, "edges", false);
+
+    if (newId != NULL) {
+        start = nowSeconds();
+        Prim = restoreOrder(Prim, newId, n);
+        reportPhase(out, "restore_order", nowSeconds() - start, n, "nodes", false);
+    }
+
+    start = nowSeconds();
+    int* parentCost = treeEdgeCosts(Net, Prim, newId);
+    free(newId);
+    Graph* PrimPath = build_paths(Prim, parentCost, n);
+    if (config->compressed)
+        PackedPath = compressGraph(PrimPath);
+    reportPhase(out, "build_paths", nowSeconds() - start, n, "nodes", false);
+
+    start = nowSeconds();
+    PathIndex* Index = buildPathIndex(Prim, n);
+    reportPhase(out, "build_path_index", nowSeconds() - start, n, "nodes", false);
+
+    start = nowSeconds();
+    CostIndex* Costs = buildCostIndex(Index, Prim, parentCost);
+    reportPhase(out, "build_cost_index", nowSeconds() - start, n, "nodes", false);
+
+    // The same seeded query pairs for both query phases.
+    PathWorkspace* ws = makePathWorkspace(n);
+    if (config->forest)
+        labelPathComponents(ws, Prim); // Queries between trees skip the search.
+    unsigned long long queryState = state;
+    start = nowSeconds();
+    for (q = 0; q < config->queries && n > 0; q++) {
+        int first = randomBelow(&queryState, n), last = randomBelow(&queryState, n);
+        if (config->compressed)
+            find_and_print_compressed_path(PackedPath, ws, first, last);
+        else
+            find_and_print_path(PrimPath, ws, first, last);
+    }
+    fflush(stdout);
+    reportPhase(out, "find_and_print_path", nowSeconds() - start, config->queries, "queries", false);
+
+    queryState = state;
+    start = nowSeconds();
+    for (q = 0; q < config->queries && n > 0; q++)
+        printIndexedPath(Index, randomBelow(&queryState, n), randomBelow(&queryState, n));
+    fflush(stdout);
+    reportPhase(out, "indexed_path_query", nowSeconds() - start, config->queries, "queries", false);
+
+    queryState = state;
+    start = nowSeconds();
+    for (q = 0; q < config->queries && n > 0; q++)
+        printPathCost(Costs, randomBelow(&queryState, n), randomBelow(&queryState, n));
+    fflush(stdout);
+    reportPhase(out, "path_cost_query", nowSeconds() - start, config->queries, "queries", true);
+
+    fprintf(out, "],\"adjacency_bytes\":%zu}\n", adjacencyBytes);
+    fclose(out);
+
+    if (config->compressed) {
+        freeCompressedGraph(Packed);
+        freeCompressedGraph(PackedPath);
+    }
+    freePathWorkspace(ws);
+    freeCostIndex(Costs);
+    freePathIndex(Index);
+    free(parentCost);
+    freeGraph(PrimPath);
+    free(Prim);
+    freeGraph(Net);
+    return 0;
+}
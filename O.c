@@ -0,0 +1,42 @@
+#include "pro.h"
+
+#ifdef NET_STATS
+NetStats netStats;
+#endif
+
+void statsPhase(const char* name, double seconds) {
+    // Appends a phase timing; phases beyond STATS_MAX_PHASES are dropped.
+#ifdef NET_STATS
+    if (netStats.phaseCount < STATS_MAX_PHASES) {
+        netStats.phaseNames[netStats.phaseCount] = name;
+        netStats.phaseSeconds[netStats.phaseCount++] = seconds;
+    }
+#else
+    (void)name;
+    (void)seconds;
+#endif
+}
+
+void dumpStats(void) {
+    // Writes every counter and phase timing as one JSON object on stderr, so the
+    // program's own output on stdout is unchanged.
+#ifdef NET_STATS
+    NetStats* s = &netStats;
+    int i;
+
+    fprintf(stderr, "{\"enabled\":true,\"heap_pops\":%lld,\"sift_down_steps\":%lld,"
+        "\"decrease_key_calls\":%lld,\"decrease_key_lowered\":%lld,\"radix_moves\":%lld,"
+        "\"segment_shifts\":%lld,\"duplicate_checks\":%lld,\"edge_probes\":%lld,"
+        "\"allocations\":%lld,\"allocated_bytes\":%lld,\"path_queries\":%lld,"
+        "\"dfs_queries\":%lld,\"dfs_nodes_visited\":%lld,\"dfs_nodes_per_query\":%.2f,\"indexed_path_steps\":%lld,\"phases\":{",
+        s->heapPops, s->siftDownSteps, s->decreaseKeyCalls, s->decreaseKeyLowered, s->radixMoves,
+        s->segmentShifts, s->duplicateChecks, s->edgeProbes, s->allocations, s->allocatedBytes,
+        s->pathQueries, s->dfsQueries, s->dfsNodesVisited,
+        s->dfsQueries > 0 ? (double)s->dfsNodesVisited / s->dfsQueries : 0.0, s->indexedPathSteps);
+    for (i = 0; i < s->phaseCount; i++)
+        fprintf(stderr, "%s\"%s\":%.6f", i > 0 ? "," : "", s->phaseNames[i], s->phaseSeconds[i]);
+    fprintf(stderr, "}}\n");
+#else
+    fprintf(stderr, "{\"enabled\":false}\n"); // Built without NET_STATS.
+#endif
+}
@@ -0,0 +1,208 @@
+#include "pro.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define DENSE_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#define TARGET_SSE41
+#else
+#define TARGET_AVX2  __attribute__((target("avx2")))
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#endif
+#endif
+
+bool isDenseGraph(Graph* Net) {
+    // The row scans pay off once a quarter of all node pairs are connected (E >= V*V/8).
+    long long n = Net->n, edges = Net->m / 2;
+    return n > 1 && edges * DENSE_MIN_FILL >= n * n;
+}
+
+int* build_dense_prim_tree(Graph* Net) {
+    // O(V^2) Prim with vectorized scans. key[v] is the cheapest known link of v to the tree, or
+    // DENSE_IN_TREE once v is in it; ties go to the lower node, so the result matches build_prim_tree.
+    // The cost matrix is materialized one row at a time: the extracted node's neighbors are
+    // scattered into a cache-resident row of INT_MAX (missing connection), which the kernel resets.
+    // A full V*V matrix built from the CSR graph costs more memory traffic than Prim itself.
+    int n = Net->n, u, next, j, steps;
+    Arena* workspace = makeArena(2 * ARENA_ALIGN + sizeof(int) * 2 * (size_t)n);
+    int* row = (int*)arenaAlloc(workspace, sizeof(int) * n);
+    int* key = (int*)arenaAlloc(workspace, sizeof(int) * n);
+    int* prim = buildPrim(n);
+    DenseKernel relax = selectDenseKernel();
+
+    for (u = 0; u < n; u++) {
+        row[u] = INT_MAX;
+        key[u] = INT_MAX;
+    }
+
+    key[0] = 0; // Root node, parent -1.
+    for (u = 0, steps = 0; steps < n; steps++, u = next) {
+        if (key[u] == INT_MAX) {
+            printf("Cannot build Prim"); // The cheapest remaining node is unreachable.
+            exit(1);
+        }
+        key[u] = DENSE_IN_TREE;
+        for (j = Net->offsets[u]; j < Net->offsets[u + 1]; j++)
+            row[Net->neighbors[j]] = Net->costs[j];
+        next = relax(key, prim, row, n, u); // Relax u's row, clear it and pick the next node.
+    }
+
+    freeArena(workspace);
+    return prim;
+}
+
+int denseRelaxScalar(int* key, int* parent, int* row, int n, int u) {
+    // Lowers key[v] to row[v] (parent u) where that is cheaper, resets the row to INT_MAX and
+    // returns the node with the smallest key, lowest id first. Compared as unsigned, DENSE_IN_TREE (-1) sorts after every
+    // real cost, and it can never be lowered because costs are not negative.
+    unsigned int best = UINT_MAX;
+    int v, next = -1;
+
+    for (v = 0; v < n; v++) {
+        if (row[v] < key[v]) {
+            key[v] = row[v];
+            parent[v] = u;
+        }
+        row[v] = INT_MAX;
+        if ((unsigned int)key[v] < best) {
+            best = (unsigned int)key[v];
+            next = v;
+        }
+    }
+    return next;
+}
+
+#ifdef DENSE_SIMD
+TARGET_AVX2 int denseRelaxAvx2(int* key, int* parent, int* row, int n, int u) {
+    // denseRelaxScalar, eight nodes per step: blend the lowered keys and parents, keep a
+    // running unsigned minimum, then find the first node holding it.
+    __m256i vu = _mm256_set1_epi32(u), vmin = _mm256_set1_epi32(-1), vbest;
+    __m256i vmissing = _mm256_set1_epi32(INT_MAX);
+    unsigned int lanes[8], best = UINT_MAX;
+    int v, i, mask;
+
+    for (v = 0; v + 8 <= n; v += 8) {
+        __m256i k = _mm256_loadu_si256((const __m256i*)(key + v));
+        __m256i r = _mm256_loadu_si256((const __m256i*)(row + v));
+        __m256i lower = _mm256_cmpgt_epi32(k, r);
+        __m256i p = _mm256_loadu_si256((const __m256i*)(parent + v));
+        _mm256_storeu_si256((__m256i*)(row + v), vmissing);
+        k = _mm256_blendv_epi8(k, r, lower);
+        _mm256_storeu_si256((__m256i*)(key + v), k);
+        _mm256_storeu_si256((__m256i*)(parent + v), _mm256_blendv_epi8(p, vu, lower));
+        vmin = _mm256_min_epu32(vmin, k);
+    }
+    _mm256_storeu_si256((__m256i*)lanes, vmin);
+    for (i = 0; i < 8; i++)
+        best = lanes[i] < best ? lanes[i] : best;
+    for (i = v; i < n; i++) {
+        if (row[i] < key[i]) {
+            key[i] = row[i];
+            parent[i] = u;
+        }
+        row[i] = INT_MAX;
+        best = (unsigned int)key[i] < best ? (unsigned int)key[i] : best;
+    }
+    if (best == UINT_MAX)
+        return -1; // Every node is in the tree.
+
+    vbest = _mm256_set1_epi32((int)best);
+    for (v = 0; v + 8 <= n; v += 8) {
+        mask = _mm256_movemask_ps(_mm256_castsi256_ps(
+            _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(key + v)), vbest)));
+        if (mask != 0) {
+            for (i = 0; !(mask & (1 << i)); i++)
+                ;
+            return v + i;
+        }
+    }
+    for (; v < n && (unsigned int)key[v] != best; v++)
+        ;
+    return v;
+}
+
+TARGET_SSE41 int denseRelaxSse41(int* key, int* parent, int* row, int n, int u) {
+    // The AVX2 kernel with four nodes per step.
+    __m128i vu = _mm_set1_epi32(u), vmin = _mm_set1_epi32(-1), vbest;
+    __m128i vmissing = _mm_set1_epi32(INT_MAX);
+    unsigned int lanes[4], best = UINT_MAX;
+    int v, i, mask;
+
+    for (v = 0; v + 4 <= n; v += 4) {
+        __m128i k = _mm_loadu_si128((const __m128i*)(key + v));
+        __m128i r = _mm_loadu_si128((const __m128i*)(row + v));
+        __m128i lower = _mm_cmpgt_epi32(k, r);
+        __m128i p = _mm_loadu_si128((const __m128i*)(parent + v));
+        _mm_storeu_si128((__m128i*)(row + v), vmissing);
+        k = _mm_blendv_epi8(k, r, lower);
+        _mm_storeu_si128((__m128i*)(key + v), k);
+        _mm_storeu_si128((__m128i*)(parent + v), _mm_blendv_epi8(p, vu, lower));
+        vmin = _mm_min_epu32(vmin, k);
+    }
+    _mm_storeu_si128((__m128i*)lanes, vmin);
+    for (i = 0; i < 4; i++)
+        best = lanes[i] < best ? lanes[i] : best;
+    for (i = v; i < n; i++) {
+        if (row[i] < key[i]) {
+            key[i] = row[i];
+            parent[i] = u;
+        }
+        row[i] = INT_MAX;
+        best = (unsigned int)key[i] < best ? (unsigned int)key[i] : best;
+    }
+    if (best == UINT_MAX)
+        return -1; // Every node is in the tree.
+
+    vbest = _mm_set1_epi32((int)best);
+    for (v = 0; v + 4 <= n; v += 4) {
+        mask = _mm_movemask_ps(_mm_castsi128_ps(
+            _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(key + v)), vbest)));
+        if (mask != 0) {
+            for (i = 0; !(mask & (1 << i)); i++)
+                ;
+            return v + i;
+        }
+    }
+    for (; v < n && (unsigned int)key[v] != best; v++)
+        ;
+    return v;
+}
+#endif
+
+DenseKernel selectDenseKernel(void) {
+    // Picks the widest kernel the CPU supports; DENSE_KERNEL=scalar|sse41|avx2 overrides
+    // the choice (down to what the CPU has), which is useful to compare them.
+    const char* forced = getenv("DENSE_KERNEL");
+    bool avx2 = false, sse41 = false;
+
+#ifdef DENSE_SIMD
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    sse41 = (info[2] & (1 << 19)) != 0;
+    if ((info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6) { // The OS saves the YMM registers.
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    sse41 = __builtin_cpu_supports("sse4.1") != 0;
+    avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+    if (forced != NULL && strcmp(forced, "avx2") != 0)
+        avx2 = false;
+    if (forced != NULL && strcmp(forced, "avx2") != 0 && strcmp(forced, "sse41") != 0)
+        sse41 = false;
+    if (avx2)
+        return denseRelaxAvx2;
+    if (sse41)
+        return denseRelaxSse41;
+#else
+    (void)forced;
+    (void)avx2;
+    (void)sse41;
+#endif
+    return denseRelaxScalar;
+}
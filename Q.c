@@ -0,0 +1,154 @@
+#include "pro.h"
+
+size_t varintSize(unsigned int value) {
+    // Seven payload bits per byte.
+    size_t bytes = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        bytes++;
+    }
+    return bytes;
+}
+
+unsigned char* writeVarint(unsigned char* out, unsigned int value) {
+    // Writes `value` in LEB128 and returns the position after it.
+    while (value >= 0x80) {
+        *out++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (unsigned char)value;
+    return out;
+}
+
+unsigned int zigzagGap(int from, int to) {
+    // Maps the signed gap to - from onto 0, 1, 2, ... (0 -> 0, -1 -> 1, 1 -> 2, -2 -> 3, ...).
+    int gap = to - from;
+    return gap >= 0 ? 2u * (unsigned int)gap : 2u * (unsigned int)(-(gap + 1)) + 1u;
+}
+
+CompressedGraph* compressGraph(Graph* graph) {
+    // Two passes over the CSR lists: the first sizes every encoded list, so the offsets and
+    // data can share one exactly sized arena block; the second writes them.
+    int n = graph->n, v, j, prev;
+    size_t bytes = 0;
+    size_t* sizes = (size_t*)allocOrExit(sizeof(size_t) * ((size_t)n + 1));
+
+    for (v = 0; v < n; v++) {
+        sizes[v] = bytes;
+        for (j = graph->offsets[v], prev = v; j < graph->offsets[v + 1]; prev = graph->neighbors[j++])
+            bytes += varintSize(zigzagGap(prev, graph->neighbors[j])) + varintSize((unsigned int)graph->costs[j]);
+    }
+    sizes[n] = bytes;
+
+    Arena* arena = makeArena(3 * ARENA_ALIGN + sizeof(CompressedGraph) + sizeof(size_t) * ((size_t)n + 1) + bytes);
+    CompressedGraph* packed = (CompressedGraph*)arenaAlloc(arena, sizeof(CompressedGraph));
+    packed->n = n;
+    packed->m = graph->m;
+    packed->offsets = (size_t*)arenaAlloc(arena, sizeof(size_t) * ((size_t)n + 1));
+    packed->data = (unsigned char*)arenaAlloc(arena, bytes);
+    packed->arena = arena;
+    memcpy(packed->offsets, sizes, sizeof(size_t) * ((size_t)n + 1));
+    free(sizes);
+
+    for (v = 0; v < n; v++) {
+        unsigned char* out = packed->data + packed->offsets[v];
+        for (j = graph->offsets[v], prev = v; j < graph->offsets[v + 1]; prev = graph->neighbors[j++]) {
+            out = writeVarint(out, zigzagGap(prev, graph->neighbors[j]));
+            out = writeVarint(out, (unsigned int)graph->costs[j]);
+        }
+    }
+
+    return packed;
+}
+
+void freeCompressedGraph(CompressedGraph* graph) {
+    // The struct lives in its own arena.
+    freeArena(graph->arena);
+}
+
+int* build_compressed_prim_tree(CompressedGraph* Net) {
+    // build_prim_tree with the edge lists decoded on the fly.
+    int n = Net->n, v0 = 0, v;
+    EdgeIterator it;
+
+    Arena* workspace = makeArena(4 * ARENA_ALIGN + sizeof(CandidateHeap) +
+        (size_t)n * (sizeof(int) + sizeof(bool) + sizeof(Candidate) + sizeof(int)));
+    int* prim = buildPrim(n);
+    int* minArr = buildMinArr(workspace, n);
+    bool* inT = buildIntList(workspace, n);
+
+    CandidateHeap* priority = buildPriority(workspace, n);
+    if (n == 0) {
+        freeArena(workspace); // An empty network has an empty tree.
+        return prim;
+    }
+    minArr[v0] = 0;
+    prim[v0] = -1;
+    decreaseKey(priority, v0, 0);
+
+    while (priority->size > 0) {
+        int u = deleteMin(priority);
+
+        if (minArr[u] == INT_MAX) {
+            printf("Cannot build Prim");
+            exit(1);
+        }
+        inT[u] = true;
+
+        for (beginEdges(Net, u, &it); nextEdge(&it);) {
+            v = it.neighbor;
+            if ((!inT[v]) && (it.cost < minArr[v])) {
+                minArr[v] = it.cost;
+                prim[v] = u;
+                decreaseKey(priority, v, it.cost);
+            }
+        }
+    }
+
+    freeArena(workspace);
+    return prim;
+}
+
+void find_and_print_compressed_path(CompressedGraph* tree, PathWorkspace* ws, int first, int last) {
+    // find_and_print_path on a compressed tree. A tree has one path between two nodes, so the
+    // search order does not matter: each node's whole list is expanded at once, and the
+    // iterator never has to be suspended on the stack.
+    int size = tree->n, top = 0, u;
+    EdgeIterator it;
+
+    if (first >= size || first < 0 || last >= size || last < 0) {
+        printf("invalid input");
+        exit(1);
+    }
+    STAT_ADD(pathQueries, 1);
+
+    if (ws->component != NULL && ws->component[first] != ws->component[last]) {
+        printf("NO PATH\n");
+        return;
+    }
+
+    startPathQuery(ws);
+    visitNode(ws, first, GRAY, -1);
+    if (first == last) { // The one-node path, as Findpathit and the path index give it.
+        printpathit(ws, first, last);
+        return;
+    }
+    ws->stack[top++] = first;
+    while (top > 0) {
+        u = ws->stack[--top];
+        for (beginEdges(tree, u, &it); nextEdge(&it);) {
+            if (it.neighbor == last) { // Same check order as Findpathit.
+                visitNode(ws, last, BLACK, u);
+                printpathit(ws, first, last);
+                return;
+            }
+            if (nodeColor(ws, it.neighbor) == WHITE) {
+                visitNode(ws, it.neighbor, GRAY, u);
+                ws->stack[top++] = it.neighbor;
+            }
+        }
+        ws->color[u] = BLACK;
+    }
+
+    printf("NO PATH\n");
+}
@@ -0,0 +1,130 @@
+#include "pro.h"
+
+bool inputEdgeLess(const InputEdge* x, const InputEdge* y) {
+    // The (cost, low end, high end) order shared by the Boruvka and Kruskal engines.
+    if (x->cost != y->cost)
+        return x->cost < y->cost;
+    if (x->a != y->a)
+        return x->a < y->a;
+    return x->b < y->b;
+}
+
+int compareInputEdges(const void* x, const void* y) {
+    // qsort order of inputEdgeLess.
+    const InputEdge* a = (const InputEdge*)x, * b = (const InputEdge*)y;
+    return inputEdgeLess(a, b) ? -1 : inputEdgeLess(b, a);
+}
+
+int* build_streaming_tree(Reader* in, int n, size_t budget) {
+    // Semi-external Kruskal: only O(n) state and one bounded chunk of edges are in memory.
+    // Each full chunk is sorted and merged with the spanning forest of everything read so
+    // far; by the cycle property the forest of (forest + chunk) is the forest of all edges
+    // seen, so the input is read once and nothing is spilled to disk.
+    InputEdge* chunk, * forest, * next, * swap;
+    int* parent, * rank;
+    int M, i, a, b, price, size = 0, count = 0;
+    size_t fixed = (size_t)n * STREAM_NODE_BYTES, capacity;
+    int* prim;
+
+    if (n < 0) {
+        printf("Invalid input.");
+        exit(1);
+    }
+
+    printf("Enter the numbers of lines:");
+    fflush(stdout);
+    if (!readInt(in, &M)) {
+        printf("invalid input");
+        exit(1);
+    }
+    if (M < 0)
+        M = 0;
+
+    // What is left of the budget after the per-node arrays holds the chunk and its sort buffers.
+    capacity = budget > fixed ? (budget - fixed) / STREAM_EDGE_BYTES : 0;
+    if (capacity < STREAM_MIN_CHUNK)
+        capacity = STREAM_MIN_CHUNK;
+    if (capacity > (size_t)M)
+        capacity = M > 0 ? (size_t)M : 1;
+
+    Arena* state = makeArena(5 * ARENA_ALIGN + sizeof(int) * 2 * (size_t)n +
+        sizeof(InputEdge) * (2 * (size_t)n + capacity));
+    parent = (int*)arenaAlloc(state, sizeof(int) * n);
+    rank = (int*)arenaAlloc(state, sizeof(int) * n);
+    forest = (InputEdge*)arenaAlloc(state, sizeof(InputEdge) * n);
+    next = (InputEdge*)arenaAlloc(state, sizeof(InputEdge) * n);
+    chunk = (InputEdge*)arenaAlloc(state, sizeof(InputEdge) * capacity);
+
+    for (i = 0; i < M; i++) {
+        if (!readInt(in, &a) || !readInt(in, &b) || !readInt(in, &price))
+            a = -1; // A truncated line is rejected like any other invalid edge.
+        if (a >= n || a < 0 || b >= n || b < 0 || price < 0 || a == b) {
+            printf("invalid input");
+            freeArena(state);
+            exit(1);
+        }
+        chunk[size].a = a < b ? a : b;
+        chunk[size].b = a < b ? b : a;
+        chunk[size++].cost = price;
+
+        if ((size_t)size == capacity || i == M - 1) {
+            count = mergeChunk(chunk, size, forest, count, next, parent, rank, n);
+            swap = forest;
+            forest = next;
+            next = swap;
+            size = 0;
+        }
+    }
+
+    if (n > 0 && count != n - 1) {
+        printf("Cannot build Prim"); // Not every node is reachable, so no spanning tree exists.
+        exit(1);
+    }
+
+    prim = treeToPrim(forest, count, n);
+    freeArena(state);
+    return prim;
+}
+
+int mergeChunk(InputEdge* chunk, int size, InputEdge* forest, int count, InputEdge* next,
+    int* parent, int* rank, int n) {
+    // Sorts the chunk, then runs Kruskal over the merge of two sorted runs (the current
+    // forest and the chunk), writing the surviving edges to `next`. Returns their number.
+    int i = 0, j = 0, kept = 0;
+    InputEdge* edge;
+
+    // (low, high) first, then a stable sort by cost: the same order as build_kruskal_tree.
+    // The (low, high) pass counts over n + 1 buckets, so a chunk much smaller than n (a
+    // tight budget, or the last chunk) is sorted by comparisons in O(size log size) instead.
+    if ((size_t)size < (size_t)n / STREAM_QSORT_RATIO)
+        qsort(chunk, size, sizeof(InputEdge), compareInputEdges);
+    else {
+        Arena* scratch = makeArena(ARENA_DEFAULT_BLOCK);
+        radixSortEdges(scratch, chunk, size, n);
+        radixSortByCost(scratch, chunk, size);
+        freeArena(scratch);
+    }
+
+    // Only endpoints of these edges are ever looked up, so only they need a fresh set.
+    for (int k = 0; k < count; k++) {
+        parent[forest[k].a] = forest[k].a;
+        parent[forest[k].b] = forest[k].b;
+        rank[forest[k].a] = rank[forest[k].b] = 0;
+    }
+    for (int k = 0; k < size; k++) {
+        parent[chunk[k].a] = chunk[k].a;
+        parent[chunk[k].b] = chunk[k].b;
+        rank[chunk[k].a] = rank[chunk[k].b] = 0;
+    }
+
+    while ((i < count || j < size) && kept < n - 1) {
+        if (j == size || (i < count && !inputEdgeLess(&chunk[j], &forest[i])))
+            edge = &forest[i++];
+        else
+            edge = &chunk[j++];
+        if (unionSets(parent, rank, edge->a, edge->b))
+            next[kept++] = *edge;
+    }
+
+    return kept;
+}
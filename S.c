@@ -0,0 +1,177 @@
+#include "pro.h"
+
+DijkstraWorkspace* makeDijkstraWorkspace(int n) {
+    // The heap holds at most one entry per node; everything shares one arena block.
+    Arena* arena = makeArena(3 * ARENA_ALIGN + sizeof(DijkstraWorkspace) +
+        (size_t)n * (sizeof(DistanceCandidate) + sizeof(int)));
+    DijkstraWorkspace* ws = (DijkstraWorkspace*)arenaAlloc(arena, sizeof(DijkstraWorkspace));
+
+    ws->n = n;
+    ws->heap.heap = (DistanceCandidate*)arenaAlloc(arena, sizeof(DistanceCandidate) * n);
+    ws->heap.location = (int*)arenaAlloc(arena, sizeof(int) * n);
+    ws->heap.size = 0;
+    ws->arena = arena;
+    return ws;
+}
+
+void freeDijkstraWorkspace(DijkstraWorkspace* ws) {
+    // The workspace struct and its arrays live in one arena.
+    freeArena(ws->arena);
+}
+
+bool distanceLess(DistanceCandidate x, DistanceCandidate y) {
+    // Ties on distance go to the lower node id, as in candidateLess.
+    if (x.dist != y.dist)
+        return x.dist < y.dist;
+    return x.node < y.node;
+}
+
+void pushDistance(DistanceHeap* heap, int v, long long dist) {
+    // Appends v as a new leaf, or lowers its key in place, and sifts it up.
+    DistanceCandidate item = { dist, v };
+    int pos = heap->location[v];
+
+    if (pos == DIST_UNSEEN)
+        pos = heap->size++;
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!distanceLess(item, heap->heap[parent]))
+            break;
+        heap->heap[pos] = heap->heap[parent];
+        heap->location[heap->heap[pos].node] = pos;
+        pos = parent;
+    }
+    heap->heap[pos] = item;
+    heap->location[v] = pos;
+}
+
+int popDistance(DistanceHeap* heap) {
+    // Removes the closest node, marks it settled and sifts the last leaf down from the root.
+    int v = heap->heap[0].node, pos = 0, size = --heap->size;
+    DistanceCandidate item = heap->heap[size];
+
+    STAT_ADD(heapPops, 1);
+    heap->location[v] = DIST_SETTLED;
+    if (size == 0)
+        return v;
+    while (2 * pos + 1 < size) {
+        int child = 2 * pos + 1;
+        if (child + 1 < size && distanceLess(heap->heap[child + 1], heap->heap[child]))
+            child++;
+        STAT_ADD(siftDownSteps, 1);
+        if (!distanceLess(heap->heap[child], item))
+            break;
+        heap->heap[pos] = heap->heap[child];
+        heap->location[heap->heap[pos].node] = pos;
+        pos = child;
+    }
+    heap->heap[pos] = item;
+    heap->location[item.node] = pos;
+    return v;
+}
+
+void dijkstra(Graph* Net, DijkstraWorkspace* ws, const int* sources, int count, long long* dist, int* pred) {
+    // Cheapest distances from the nearest of `sources` over the whole network. Fills dist
+    // (DIST_INFINITY where unreachable) and pred (-1 for sources and unreachable nodes).
+    DistanceHeap* heap = &ws->heap;
+    int n = Net->n, u, v, j, i;
+    long long d;
+
+    for (v = 0; v < n; v++) {
+        dist[v] = DIST_INFINITY;
+        pred[v] = -1;
+        heap->location[v] = DIST_UNSEEN;
+    }
+    heap->size = 0;
+
+    for (i = 0; i < count; i++) {
+        if (sources[i] < 0 || sources[i] >= n) {
+            printf("invalid input");
+            exit(1);
+        }
+        if (dist[sources[i]] != 0) { // A source listed twice is pushed once.
+            dist[sources[i]] = 0;
+            pushDistance(heap, sources[i], 0);
+        }
+    }
+
+    while (heap->size > 0) {
+        u = popDistance(heap);
+        for (j = Net->offsets[u]; j < Net->offsets[u + 1]; j++) {
+            v = Net->neighbors[j];
+            d = dist[u] + Net->costs[j];
+            if (heap->location[v] != DIST_SETTLED && d < dist[v]) {
+                STAT_ADD(decreaseKeyLowered, 1);
+                dist[v] = d;
+                pred[v] = u;
+                pushDistance(heap, v, d);
+            }
+        }
+    }
+}
+
+void dijkstraWorker(void* arg, int id) {
+    // Worker: claims sources one at a time, each run in this worker's own workspace.
+    ManySources* task = (ManySources*)arg;
+    DijkstraWorkspace* ws = makeDijkstraWorkspace(task->graph->n);
+    size_t n = (size_t)task->graph->n;
+    int i;
+    (void)id;
+
+    while ((i = atomicFetchAdd(&task->next, 1)) < task->count)
+        dijkstra(task->graph, ws, &task->sources[i], 1, task->dist + i * n, task->pred + i * n);
+
+    freeDijkstraWorkspace(ws);
+}
+
+void dijkstraManySources(Graph* Net, const int* sources, int count, int threads, long long* dist, int* pred) {
+    // Independent single-source runs spread over `threads` workers. Row i of dist and pred
+    // (count * n entries each) holds the result for sources[i].
+    ManySources task;
+
+    task.graph = Net;
+    task.sources = sources;
+    task.count = count;
+    task.dist = dist;
+    task.pred = pred;
+    task.next = 0;
+    runParallel(threads < count ? threads : (count > 0 ? count : 1), dijkstraWorker, &task);
+}
+
+void printDistances(const long long* dist, int n) {
+    // One line with the distance of every node (-1 where unreachable), formatted into a
+    // buffer and written to stdout in blocks like the text exports.
+    OutputBuffer out = { NULL, 0, 0 };
+    char* p;
+
+    reserveOutput(&out, EXPORT_BLOCK_SIZE + EXPORT_LINE_MAX);
+    p = out.data;
+    for (int v = 0; v < n; v++) {
+        p = putLong(p, dist[v] == DIST_INFINITY ? -1 : dist[v], v == n - 1 ? '\n' : ' ');
+        if ((size_t)(p - out.data) >= EXPORT_BLOCK_SIZE) {
+            out.len = (size_t)(p - out.data);
+            flushOutput(&out, stdout, "stdout");
+            p = out.data;
+        }
+    }
+    if (n == 0)
+        *p++ = '\n';
+    out.len = (size_t)(p - out.data);
+    flushOutput(&out, stdout, "stdout");
+    free(out.data);
+}
+
+void printShortestPath(int* pred, int first, int last, int* scratch) {
+    // Prints first .. last by walking the predecessors back from `last`; scratch holds n ints.
+    int count = 0, v;
+
+    for (v = last; v != first && v != -1; v = pred[v])
+        scratch[count++] = v;
+    if (v == -1) {
+        printf("NO PATH\n");
+        return;
+    }
+    scratch[count++] = first;
+    while (count > 0)
+        printf("%d ", scratch[--count]);
+}
@@ -0,0 +1,132 @@
+#include "pro.h"
+
+int* computeOrder(Graph* Net, ReorderKind kind) {
+    // Returns newId[v], the position of node v in the chosen order (a permutation of 0 .. n-1).
+    int n = Net->n, i, v, j, head, tail, start, maxDegree = 0;
+    Arena* scratch = makeArena(ARENA_DEFAULT_BLOCK);
+    int* order = (int*)arenaAlloc(scratch, sizeof(int) * n);      // order[i]: node at position i
+    int* byDegree = (int*)arenaAlloc(scratch, sizeof(int) * n);   // Nodes by ascending degree
+    long long* keys = (long long*)arenaAlloc(scratch, sizeof(long long) * n);
+    int* count;
+    bool* seen = (bool*)arenaCalloc(scratch, n, sizeof(bool));
+    int* newId = (int*)allocOrExit(sizeof(int) * n);
+
+    // Counting sort of the nodes by degree; stable, so equal degrees keep id order.
+    for (v = 0; v < n; v++)
+        if (Net->offsets[v + 1] - Net->offsets[v] > maxDegree)
+            maxDegree = Net->offsets[v + 1] - Net->offsets[v];
+    count = (int*)arenaCalloc(scratch, (size_t)maxDegree + 2, sizeof(int));
+    for (v = 0; v < n; v++)
+        count[Net->offsets[v + 1] - Net->offsets[v] + 1]++;
+    for (i = 0; i <= maxDegree; i++)
+        count[i + 1] += count[i];
+    for (v = 0; v < n; v++)
+        byDegree[count[Net->offsets[v + 1] - Net->offsets[v]]++] = v;
+
+    if (kind == REORDER_DEGREE) {
+        // Hubs first: their rows and keys are the ones touched most often.
+        for (i = 0; i < n; i++)
+            order[i] = byDegree[n - 1 - i];
+    }
+    else {
+        // BFS from node 0 (then from every node not reached yet), neighbors in id order.
+        // Cuthill-McKee starts each component at a node of lowest degree, visits the
+        // neighbors of a node by ascending degree, and the final order is reversed.
+        tail = 0;
+        for (i = 0; i < n; i++) {
+            start = kind == REORDER_RCM ? byDegree[i] : i;
+            if (seen[start])
+                continue;
+            seen[start] = true;
+            order[tail++] = start;
+            for (head = tail - 1; head < tail; head++) {
+                int first = tail;
+                v = order[head];
+                for (j = Net->offsets[v]; j < Net->offsets[v + 1]; j++) {
+                    if (!seen[Net->neighbors[j]]) {
+                        seen[Net->neighbors[j]] = true;
+                        order[tail++] = Net->neighbors[j];
+                    }
+                }
+                if (kind == REORDER_RCM)
+                    sortByDegree(Net, order + first, tail - first, keys);
+            }
+        }
+        if (kind == REORDER_RCM)
+            for (i = 0; i < n / 2; i++) {
+                v = order[i];
+                order[i] = order[n - 1 - i];
+                order[n - 1 - i] = v;
+            }
+    }
+
+    for (i = 0; i < n; i++)
+        newId[order[i]] = i;
+    freeArena(scratch);
+    return newId;
+}
+
+int compareKeys(const void* x, const void* y) {
+    // qsort order of 64-bit keys.
+    long long a = *(const long long*)x, b = *(const long long*)y;
+    return (a > b) - (a < b);
+}
+
+void sortByDegree(Graph* Net, int* nodes, int count, long long* keys) {
+    // Sorts nodes by (degree, id) through packed 64-bit keys; `keys` has room for `count`.
+    int i;
+
+    if (count < 2)
+        return;
+    for (i = 0; i < count; i++)
+        keys[i] = ((long long)(Net->offsets[nodes[i] + 1] - Net->offsets[nodes[i]]) << 32) | nodes[i];
+    qsort(keys, count, sizeof(long long), compareKeys);
+    for (i = 0; i < count; i++)
+        nodes[i] = (int)(keys[i] & 0xFFFFFFFF);
+}
+
+Graph* permuteGraph(Graph* Net, const int* newId) {
+    // Relabels every connection and rebuilds the CSR graph, neighbors ascending in the new ids.
+    Arena* scratch = makeArena(ARENA_DEFAULT_BLOCK);
+    int total, i, a, b;
+    InputEdge* edges = collectEdges(scratch, Net, &total);
+    Graph* graph;
+
+    for (i = 0; i < total; i++) {
+        a = newId[edges[i].a];
+        b = newId[edges[i].b];
+        edges[i].a = a < b ? a : b;
+        edges[i].b = a < b ? b : a;
+    }
+    radixSortEdges(scratch, edges, total, Net->n);
+    graph = edgesToGraph(scratch, edges, total, Net->n);
+
+    freeArena(scratch);
+    return graph;
+}
+
+int* restoreOrder(int* prim, const int* newId, int n) {
+    // Maps a parent array over the new ids back to the original ids, rooted as build_mst
+    // roots it (at node 0, or at the smallest node of each tree of a forest). Frees `prim`.
+    // The links keep their child -> parent orientation; treeToPrim sorts them for edgesToGraph.
+    int* oldId = (int*)allocOrExit(sizeof(int) * n);
+    InputEdge* tree = (InputEdge*)allocOrExit(sizeof(InputEdge) * n);
+    int v, count = 0;
+    int* restored;
+
+    for (v = 0; v < n; v++)
+        oldId[newId[v]] = v;
+    for (v = 0; v < n; v++) {
+        if (prim[v] != -1) {
+            tree[count].a = oldId[v];
+            tree[count].b = oldId[prim[v]];
+            tree[count++].cost = 0;
+        }
+    }
+
+    restored = treeToPrim(tree, count, n);
+    free(oldId);
+    free(tree);
+    free(prim);
+    return restored;
+}
@@ -0,0 +1,124 @@
+#include "pro.h"
+
+unsigned long long hashWords(unsigned long long hash, const int* words, size_t count) {
+    // FNV-1a over 32-bit words instead of bytes: one multiply per word.
+    for (size_t i = 0; i < count; i++)
+        hash = (hash ^ (unsigned int)words[i]) * 0x100000001B3ull;
+    return hash;
+}
+
+unsigned long long cacheKey(Graph* Net, unsigned int mode) {
+    // Hash of the ingested network (sizes and all three CSR arrays) and of the options that
+    // shape the tree, finished with the splitmix64 mixer so every input bit reaches every key bit.
+    int sizes[3] = { Net->n, Net->m, (int)mode };
+    unsigned long long hash = 0xCBF29CE484222325ull;
+
+    hash = hashWords(hash, sizes, 3);
+    hash = hashWords(hash, Net->offsets, (size_t)Net->n + 1);
+    hash = hashWords(hash, Net->neighbors, Net->m);
+    hash = hashWords(hash, Net->costs, Net->m);
+    return nextRandom(&hash);
+}
+
+char* cacheFilePath(const char* dir, unsigned long long key) {
+    // <dir>/<16 hex digits>.mst; the caller frees the string.
+    size_t length = strlen(dir) + 24;
+    char* path = (char*)allocOrExit(length);
+    snprintf(path, length, "%s/%016llx.mst", dir, key);
+    return path;
+}
+
+PathIndex* loadMstCache(const char* dir, unsigned long long key, int n, int** prim) {
+    // Maps a cache file and points a PathIndex (and *prim) at the tables inside it.
+    // Returns NULL when there is no usable entry, so the caller computes the tree.
+    char* path = cacheFilePath(dir, key);
+    FILE* probe = fopen(path, "rb");
+    MstCacheHeader* header;
+    PathIndex* index;
+    size_t size, expected;
+    char* mapping;
+    int* data;
+    long length;
+
+    if (probe == NULL) {
+        free(path);
+        return NULL;
+    }
+    fseek(probe, 0, SEEK_END);
+    length = ftell(probe);
+    fclose(probe);
+    if (length < (long)sizeof(MstCacheHeader)) {
+        free(path);
+        return NULL;
+    }
+
+    mapping = (char*)mapFile(path, &size);
+    free(path);
+    header = (MstCacheHeader*)mapping;
+    expected = sizeof(MstCacheHeader) + sizeof(int) * (size_t)n * (3 + (size_t)header->levels);
+    if (header->magic != MST_CACHE_MAGIC || header->version != MST_CACHE_VERSION ||
+        header->key != key || header->n != n || header->levels < 1 || header->levels > 31 ||
+        size != expected) {
+        unmapFile(mapping, size); // A stale or foreign file: rebuild and overwrite it.
+        return NULL;
+    }
+
+    // Layout after the header: Prim, depth, root, then the lifting table.
+    data = (int*)(mapping + sizeof(MstCacheHeader));
+    Arena* arena = makeArena(2 * ARENA_ALIGN + sizeof(PathIndex) + sizeof(int) * (size_t)n);
+    index = (PathIndex*)arenaAlloc(arena, sizeof(PathIndex));
+    index->n = n;
+    index->levels = header->levels;
+    index->depth = data + n;
+    index->root = data + 2 * (size_t)n;
+    index->up = data + 3 * (size_t)n;
+    index->scratch = (int*)arenaAlloc(arena, sizeof(int) * n);
+    index->arena = arena;
+    index->mapping = mapping;
+    index->mappingSize = size;
+
+    *prim = data;
+    return index;
+}
+
+bool saveMstCache(const char* dir, unsigned long long key, int* Prim, PathIndex* index) {
+    // Writes a cache entry under a temporary name and renames it into place, so a reader
+    // never maps a half-written file. A failure only means the next run recomputes.
+    char* path = cacheFilePath(dir, key);
+    size_t length = strlen(path) + 5, n = (size_t)index->n;
+    char* temp = (char*)allocOrExit(length);
+    MstCacheHeader header;
+    FILE* file;
+    bool written;
+
+    snprintf(temp, length, "%s.tmp", path);
+    file = fopen(temp, "wb");
+    if (file == NULL) {
+        free(path);
+        free(temp);
+        return false;
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.magic = MST_CACHE_MAGIC;
+    header.version = MST_CACHE_VERSION;
+    header.n = index->n;
+    header.levels = index->levels;
+    header.key = key;
+
+    written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(Prim, sizeof(int), n, file) == n &&
+        fwrite(index->depth, sizeof(int), n, file) == n &&
+        fwrite(index->root, sizeof(int), n, file) == n &&
+        fwrite(index->up, sizeof(int), n * index->levels, file) == n * index->levels;
+    written = fclose(file) == 0 && written;
+
+    remove(path); // rename() does not replace an existing file on Windows.
+    written = written && rename(temp, path) == 0;
+    if (!written)
+        remove(temp);
+
+    free(path);
+    free(temp);
+    return written;
+}
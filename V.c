@@ -0,0 +1,239 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // Exposes fdopen() and the socket API under strict ISO C modes.
+#endif
+#include "pro.h"
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+void reserveOutput(OutputBuffer* out, size_t extra) {
+    // Grows the buffer (doubling) so `extra` more bytes fit.
+    if (out->len + extra <= out->cap)
+        return;
+    while (out->len + extra > out->cap)
+        out->cap = out->cap > 0 ? 2 * out->cap : OUTPUT_BUFFER_SIZE;
+    out->data = (char*)reallocOrExit(out->data, out->cap);
+}
+
+void appendOutput(OutputBuffer* out, const char* text, size_t length) {
+    // Copies `length` bytes to the end of the buffer.
+    reserveOutput(out, length);
+    memcpy(out->data + out->len, text, length);
+    out->len += length;
+}
+
+char* putLong(char* p, long long value, char end) {
+    // Formats a signed integer followed by `end`; returns the position after it.
+    char digits[20];
+    unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+    int count = 0;
+
+    if (value < 0)
+        *p++ = '-';
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (count > 0)
+        *p++ = digits[--count];
+    *p++ = end;
+    return p;
+}
+
+void formatIndexedPath(PathIndex* index, int first, int last, OutputBuffer* out) {
+    // printIndexedPath into a buffer, one line per query. Bad ids are answered with
+    // "invalid input" instead of ending the process.
+    int lca, v, value;
+    char* p, * lower, * end;
+
+    if (first >= index->n || first < 0 || last >= index->n || last < 0) {
+        appendOutput(out, "invalid input\n", 14);
+        return;
+    }
+    lca = lowestCommonAncestor(index, first, last);
+    if (lca == -1) {
+        appendOutput(out, "NO PATH\n", 8);
+        return;
+    }
+
+    // Every node takes at most 11 bytes (10 digits and a space); room is made once.
+    reserveOutput(out, 12 * ((size_t)index->depth[first] + index->depth[last] - 2 * (size_t)index->depth[lca] + 1) + 1);
+    p = out->data + out->len;
+    for (v = first; v != lca; v = index->up[v])
+        p = putLong(p, v, ' ');
+    p = putLong(p, lca, ' ');
+    // The lower half is written from `last` up, each id as a space and its digits backwards,
+    // so reversing those bytes once puts it in order without a scratch array.
+    lower = p;
+    for (v = last; v != lca; v = index->up[v]) {
+        *p++ = ' ';
+        value = v;
+        do {
+            *p++ = (char)('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+    }
+    for (end = p - 1; lower < end; lower++, end--) {
+        char swap = *lower;
+        *lower = *end;
+        *end = swap;
+    }
+    *p++ = '\n';
+    out->len = (size_t)(p - out->data);
+}
+
+void formatPathCost(CostIndex* costs, int first, int last, OutputBuffer* out) {
+    // printPathCost into a buffer; bad ids are answered with "invalid input".
+    int bottleneck;
+    long long total;
+    char* p;
+
+    if (first >= costs->index->n || first < 0 || last >= costs->index->n || last < 0)
+        appendOutput(out, "invalid input\n", 14);
+    else if (!queryPathCost(costs, first, last, &bottleneck, &total))
+        appendOutput(out, "NO PATH\n", 8);
+    else {
+        reserveOutput(out, 32); // 10 + 1 + 19 + 1 bytes at most.
+        p = putLong(out->data + out->len, bottleneck, ' ');
+        p = putLong(p, total, '\n');
+        out->len = (size_t)(p - out->data);
+    }
+}
+
+void answerQueries(void* arg, int id) {
+    // Worker: formats one contiguous slice of the batch into its own buffer, so the
+    // buffers concatenated in worker order are the answers in query order.
+    QueryBatch* batch = (QueryBatch*)arg;
+    int from = (int)((long long)batch->count * id / batch->workers);
+    int to = (int)((long long)batch->count * (id + 1) / batch->workers);
+    OutputBuffer* out = &batch->outputs[id];
+
+    for (int q = from; q < to; q++) {
+        if (batch->first[q] == QUERY_MALFORMED)
+            appendOutput(out, "Invalid input.\n", 15);
+        else if (batch->costs != NULL)
+            formatPathCost(batch->costs, batch->first[q], batch->last[q], out);
+        else
+            formatIndexedPath(batch->index, batch->first[q], batch->last[q], out);
+    }
+}
+
+void runQueryBatch(QueryBatch* batch, FILE* out) {
+    // Answers the pending queries and writes them with one fwrite per worker buffer.
+    int workers = batch->count >= QUERY_PARALLEL_MIN ? batch->threads : 1, w;
+
+    batch->workers = workers;
+    for (w = 0; w < workers; w++)
+        batch->outputs[w].len = 0;
+    if (workers > 1)
+        runParallel(workers, answerQueries, batch);
+    else
+        answerQueries(batch, 0);
+
+    for (w = 0; w < workers; w++)
+        fwrite(batch->outputs[w].data, 1, batch->outputs[w].len, out);
+    fflush(out);
+    batch->count = 0;
+}
+
+bool readQuery(Reader* in, int* first, int* last) {
+    // Reads the next "first last" pair; false at end of input. A line with a token that is
+    // not a number is dropped and comes back as one QUERY_MALFORMED query, so the server
+    // answers it and goes on with the next line.
+    if (readInt(in, first) && readInt(in, last))
+        return true;
+    if (!in->badToken)
+        return false;
+    skipLine(in);
+    *first = *last = QUERY_MALFORMED;
+    return true;
+}
+
+long long serveQueries(PathIndex* index, CostIndex* costs, Reader* in, FILE* out, int threads) {
+    // Answers "first last" pairs until the input ends. Queries are collected while more input
+    // is already buffered (up to QUERY_BATCH), so a pipe is answered in large batches while an
+    // interactive client still gets each answer before the server blocks for the next line.
+    QueryBatch batch;
+    long long answered = 0;
+    int w, first, last;
+
+    batch.index = index;
+    batch.costs = costs;
+    batch.threads = threads > 0 ? threads : 1;
+    batch.count = 0;
+    batch.first = (int*)allocOrExit(sizeof(int) * QUERY_BATCH);
+    batch.last = (int*)allocOrExit(sizeof(int) * QUERY_BATCH);
+    batch.outputs = (OutputBuffer*)allocOrExit(sizeof(OutputBuffer) * batch.threads);
+    for (w = 0; w < batch.threads; w++) {
+        batch.outputs[w].data = NULL;
+        batch.outputs[w].len = batch.outputs[w].cap = 0;
+        reserveOutput(&batch.outputs[w], OUTPUT_BUFFER_SIZE);
+    }
+
+    while (readQuery(in, &first, &last)) {
+        batch.first[batch.count] = first;
+        batch.last[batch.count++] = last;
+        answered++;
+        if (batch.count == QUERY_BATCH || !inputPending(in))
+            runQueryBatch(&batch, out);
+    }
+    if (batch.count > 0)
+        runQueryBatch(&batch, out);
+
+    for (w = 0; w < batch.threads; w++)
+        free(batch.outputs[w].data);
+    free(batch.outputs);
+    free(batch.first);
+    free(batch.last);
+    return answered;
+}
+
+int serveSocket(PathIndex* index, CostIndex* costs, const char* path, int threads) {
+    // Listens on a Unix domain socket and serves one connection at a time, each as a
+    // query stream like stdin. Runs until the process is stopped.
+#ifdef _WIN32
+    (void)index;
+    (void)costs;
+    (void)path;
+    (void)threads;
+    printf("--socket is not supported on Windows");
+    return 1;
+#else
+    struct sockaddr_un address;
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0), client;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (listener < 0 || strlen(path) >= sizeof(address.sun_path)) {
+        printf("cannot listen on %s", path);
+        return 1;
+    }
+    strcpy(address.sun_path, path);
+    signal(SIGPIPE, SIG_IGN); // A client that disconnects early must not stop the server.
+    unlink(path); // A socket file left by an earlier server.
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 16) != 0) {
+        printf("cannot listen on %s", path);
+        close(listener);
+        return 1;
+    }
+
+    while ((client = accept(listener, NULL, NULL)) >= 0) {
+        FILE* stream = fdopen(client, "r+");
+        if (stream == NULL) {
+            close(client);
+            continue;
+        }
+        Reader* in = openReader(stream);
+        serveQueries(index, costs, in, stream, threads);
+        closeReader(in);
+        fclose(stream);
+    }
+
+    close(listener);
+    return 0;
+#endif
+}
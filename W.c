@@ -0,0 +1,138 @@
+#include "pro.h"
+
+int* treeEdgeCosts(Graph* Net, int* Prim, const int* newId) {
+    // Cost of every node's parent edge, looked up in the network in O(log degree); roots get 0.
+    // With `newId`, the network is the relabeled one and `Prim` uses the original ids.
+    int n = Net->n, v;
+    int* cost = (int*)allocOrExit(sizeof(int) * n);
+
+    for (v = 0; v < n; v++) {
+        if (Prim[v] == -1)
+            cost[v] = 0;
+        else if (newId != NULL)
+            cost[v] = findEdgeCost(Net, newId[v], newId[Prim[v]]);
+        else
+            cost[v] = findEdgeCost(Net, v, Prim[v]);
+    }
+
+    return cost;
+}
+
+CostIndex* buildCostIndex(PathIndex* index, int* Prim, int* parentCost) {
+    // Adds max-cost lifting tables and root distances to a path index in O(n log n).
+    // Depths are known, so nodes are visited by depth and every parent comes first.
+    int n = index->n, levels = index->levels, k, v;
+    Arena* arena = makeArena(5 * ARENA_ALIGN + sizeof(CostIndex) +
+        (size_t)n * (sizeof(long long) + 2 * sizeof(int) + sizeof(int) * levels));
+    CostIndex* costs = (CostIndex*)arenaAlloc(arena, sizeof(CostIndex));
+    int* order = (int*)arenaAlloc(arena, sizeof(int) * n);
+    int* next = (int*)arenaCalloc(arena, (size_t)n + 1, sizeof(int));
+
+    costs->index = index;
+    costs->maxUp = (int*)arenaAlloc(arena, sizeof(int) * (size_t)n * levels);
+    costs->rootCost = (long long*)arenaAlloc(arena, sizeof(long long) * n);
+    costs->arena = arena;
+
+    // Counting sort by depth.
+    for (v = 0; v < n; v++)
+        next[index->depth[v] + 1]++;
+    for (v = 0; v < n; v++)
+        next[v + 1] += next[v];
+    for (v = 0; v < n; v++)
+        order[next[index->depth[v]]++] = v;
+    for (k = 0; k < n; k++) {
+        v = order[k];
+        costs->rootCost[v] = Prim[v] == -1 ? 0 : costs->rootCost[Prim[v]] + parentCost[v];
+    }
+
+    // Level 0 is the parent edge; a jump of 2^k edges is the larger of its two halves.
+    for (v = 0; v < n; v++)
+        costs->maxUp[v] = parentCost[v];
+    for (k = 1; k < levels; k++) {
+        int* prevUp = index->up + (size_t)(k - 1) * n;
+        int* prevMax = costs->maxUp + (size_t)(k - 1) * n;
+        int* currMax = costs->maxUp + (size_t)k * n;
+        for (v = 0; v < n; v++) {
+            int half = prevMax[prevUp[v]];
+            currMax[v] = prevMax[v] > half ? prevMax[v] : half;
+        }
+    }
+
+    return costs;
+}
+
+bool queryPathCost(CostIndex* costs, int u, int v, int* bottleneck, long long* total) {
+    // Most expensive edge and total cost of the tree path u - v in O(log n); false across trees.
+    // A path without edges (u == v) has bottleneck 0.
+    PathIndex* index = costs->index;
+    int k, diff, n = index->n, worst = 0, lca;
+    long long sum = costs->rootCost[u] + costs->rootCost[v];
+
+    if (index->root[u] != index->root[v])
+        return false;
+
+    // Lift the deeper node to the depth of the other one, keeping the largest edge passed.
+    if (index->depth[u] < index->depth[v]) {
+        int temp = u;
+        u = v;
+        v = temp;
+    }
+    diff = index->depth[u] - index->depth[v];
+    for (k = 0; diff > 0; k++, diff >>= 1) {
+        if (diff & 1) {
+            int* level = costs->maxUp + (size_t)k * n;
+            if (level[u] > worst)
+                worst = level[u];
+            u = index->up[(size_t)k * n + u];
+        }
+    }
+
+    if (u != v) {
+        // Lift both while their ancestors differ; the last step to the LCA is one edge each.
+        for (k = index->levels - 1; k >= 0; k--) {
+            int* up = index->up + (size_t)k * n;
+            int* level = costs->maxUp + (size_t)k * n;
+            if (up[u] != up[v]) {
+                if (level[u] > worst)
+                    worst = level[u];
+                if (level[v] > worst)
+                    worst = level[v];
+                u = up[u];
+                v = up[v];
+            }
+        }
+        if (costs->maxUp[u] > worst)
+            worst = costs->maxUp[u];
+        if (costs->maxUp[v] > worst)
+            worst = costs->maxUp[v];
+        u = index->up[u];
+    }
+    lca = u;
+
+    *bottleneck = worst;
+    *total = sum - 2 * costs->rootCost[lca];
+    return true;
+}
+
+void printPathCost(CostIndex* costs, int first, int last) {
+    // Prints "bottleneck total" for the tree path first -> last, or NO PATH across trees.
+    int bottleneck;
+    long long total;
+
+    if (first >= costs->index->n || first < 0 || last >= costs->index->n || last < 0) {
+        printf("invalid input");
+        exit(1);
+    }
+    STAT_ADD(pathQueries, 1);
+
+    if (!queryPathCost(costs, first, last, &bottleneck, &total)) {
+        printf("NO PATH\n");
+        return;
+    }
+    printf("%d %lld\n", bottleneck, total);
+}
+
+void freeCostIndex(CostIndex* costs) {
+    // The tables live in one arena; the path index belongs to the caller.
+    freeArena(costs->arena);
+}
@@ -0,0 +1,210 @@
+#include "pro.h"
+
+bool growArray(void** array, size_t bytes) {
+    // realloc that leaves `*array` untouched (and still owned) when memory runs out.
+    void* memory = realloc(*array, bytes > 0 ? bytes : 1);
+    STAT_ADD(allocations, 1);
+    STAT_ADD(allocatedBytes, (long long)bytes);
+    if (memory == NULL)
+        return false;
+    *array = memory;
+    return true;
+}
+
+NetStatus reserveNodes(NetContext* ctx, int n) {
+    // Grows every per-node buffer to n nodes; smaller networks reuse them as they are.
+    size_t count = (size_t)n;
+    PathWorkspace* ws = &ctx->pathWork;
+
+    if (n <= ctx->nodeCapacity)
+        return NET_OK;
+    if (!growArray((void**)&ctx->net.offsets, sizeof(int) * (count + 1)) ||
+        !growArray((void**)&ctx->tree.offsets, sizeof(int) * (count + 1)) ||
+        !growArray((void**)&ctx->tree.neighbors, sizeof(int) * 2 * count) ||
+        !growArray((void**)&ctx->tree.costs, sizeof(int) * 2 * count) ||
+        !growArray((void**)&ctx->count, sizeof(int) * (count + 1)) ||
+        !growArray((void**)&ctx->prim, sizeof(int) * count) ||
+        !growArray((void**)&ctx->parentCost, sizeof(int) * count) ||
+        !growArray((void**)&ctx->primWork.minArr, sizeof(int) * count) ||
+        !growArray((void**)&ctx->primWork.inT, sizeof(bool) * count) ||
+        !growArray((void**)&ctx->primWork.priority.heap, sizeof(Candidate) * count) ||
+        !growArray((void**)&ctx->primWork.priority.location, sizeof(int) * count) ||
+        !growArray((void**)&ws->stamp, sizeof(unsigned int) * count) ||
+        !growArray((void**)&ws->color, sizeof(int) * count) ||
+        !growArray((void**)&ws->parent, sizeof(int) * count) ||
+        !growArray((void**)&ws->stack, sizeof(int) * count) ||
+        !growArray((void**)&ws->edge, sizeof(int) * count))
+        return NET_ERROR_MEMORY;
+
+    // Fresh stamps: every node reads as WHITE until the next query touches it.
+    memset(ws->stamp, 0, sizeof(unsigned int) * count);
+    ws->epoch = 0;
+    ws->n = n;
+    ctx->nodeCapacity = n;
+    return NET_OK;
+}
+
+NetStatus reserveEdges(NetContext* ctx, int m) {
+    // Grows every per-connection buffer to m connections (2 * m stored edges).
+    size_t count = (size_t)m;
+
+    if (m <= ctx->edgeCapacity)
+        return NET_OK;
+    if (!growArray((void**)&ctx->edges, sizeof(InputEdge) * count) ||
+        !growArray((void**)&ctx->sorted, sizeof(InputEdge) * count) ||
+        !growArray((void**)&ctx->net.neighbors, sizeof(int) * 2 * count) ||
+        !growArray((void**)&ctx->net.costs, sizeof(int) * 2 * count))
+        return NET_ERROR_MEMORY;
+
+    ctx->edgeCapacity = m;
+    return NET_OK;
+}
+
+NetContext* netCreate(void) {
+    // All buffers start empty and are sized by the first netLoad.
+    NetContext* ctx = (NetContext*)calloc(1, sizeof(NetContext));
+    if (ctx == NULL)
+        return NULL;
+    ctx->net.arena = ctx->tree.arena = NULL; // The graphs never own their arrays.
+    ctx->nodeCapacity = ctx->edgeCapacity = -1; // Even an empty network needs its n + 1 offsets.
+    ctx->net.mapping = ctx->tree.mapping = NULL;
+    ctx->pathWork.component = NULL;
+    ctx->pathWork.arena = NULL;
+    return ctx;
+}
+
+void netDestroy(NetContext* ctx) {
+    // Frees the context and every buffer it grew.
+    if (ctx == NULL)
+        return;
+    free(ctx->net.offsets);
+    free(ctx->net.neighbors);
+    free(ctx->net.costs);
+    free(ctx->tree.offsets);
+    free(ctx->tree.neighbors);
+    free(ctx->tree.costs);
+    free(ctx->edges);
+    free(ctx->sorted);
+    free(ctx->count);
+    free(ctx->prim);
+    free(ctx->parentCost);
+    free(ctx->primWork.minArr);
+    free(ctx->primWork.inT);
+    free(ctx->primWork.priority.heap);
+    free(ctx->primWork.priority.location);
+    free(ctx->pathWork.stamp);
+    free(ctx->pathWork.color);
+    free(ctx->pathWork.parent);
+    free(ctx->pathWork.stack);
+    free(ctx->pathWork.edge);
+    free(ctx);
+}
+
+NetStatus netLoad(NetContext* ctx, int n, const int* edges, int m) {
+    // The same rules as build_net: ids in [0, n), no self loops, no negative costs, and a
+    // repeated connection keeps its first cost. After any error the context holds no network.
+    NetStatus status;
+    int i, unique;
+
+    ctx->loaded = ctx->built = false;
+    if (n < 0 || m < 0 || (m > 0 && edges == NULL))
+        return NET_ERROR_INVALID_INPUT;
+    for (i = 0; i < m; i++) {
+        int a = edges[3 * i], b = edges[3 * i + 1], cost = edges[3 * i + 2];
+        if (a >= n || a < 0 || b >= n || b < 0 || cost < 0 || a == b)
+            return NET_ERROR_INVALID_INPUT;
+    }
+    if ((status = reserveNodes(ctx, n)) != NET_OK || (status = reserveEdges(ctx, m)) != NET_OK)
+        return status;
+
+    for (i = 0; i < m; i++) {
+        int a = edges[3 * i], b = edges[3 * i + 1];
+        ctx->edges[i].a = a < b ? a : b; // Store the connection under its (low, high) key.
+        ctx->edges[i].b = a < b ? b : a;
+        ctx->edges[i].cost = edges[3 * i + 2];
+    }
+    radixSortEdgesWith(ctx->edges, ctx->sorted, ctx->count, m, n);
+    unique = dedupeEdges(ctx->edges, m);
+
+    ctx->net.n = n;
+    fillGraph(&ctx->net, ctx->edges, unique, ctx->count);
+    ctx->loaded = true;
+    return NET_OK;
+}
+
+NetStatus netBuildMst(NetContext* ctx) {
+    // Prim on the context's workspace, then the tree CSR with its edge costs for path queries.
+    int n = ctx->net.n, v;
+
+    ctx->built = false;
+    if (!ctx->loaded)
+        return NET_ERROR_NO_NETWORK;
+    if (!primWithWorkspace(&ctx->net, &ctx->primWork, ctx->prim))
+        return NET_ERROR_NOT_CONNECTED;
+
+    for (v = 0; v < n; v++)
+        ctx->parentCost[v] = ctx->prim[v] == -1 ? 0 : findEdgeCost(&ctx->net, v, ctx->prim[v]);
+    ctx->tree.n = n;
+    fillPaths(&ctx->tree, ctx->prim, ctx->parentCost, ctx->count);
+    ctx->built = true;
+    return NET_OK;
+}
+
+NetStatus netParents(NetContext* ctx, const int** parents) {
+    // The array stays valid until the next netLoad or netDestroy.
+    if (!ctx->built)
+        return NET_ERROR_NO_NETWORK;
+    *parents = ctx->prim;
+    return NET_OK;
+}
+
+NetStatus netMstCost(NetContext* ctx, long long* total) {
+    // Sum of the tree edge costs.
+    long long sum = 0;
+
+    if (!ctx->built)
+        return NET_ERROR_NO_NETWORK;
+    for (int v = 0; v < ctx->tree.n; v++)
+        sum += ctx->parentCost[v];
+    *total = sum;
+    return NET_OK;
+}
+
+NetStatus netFindPath(NetContext* ctx, int first, int last, int* path, int capacity, int* length) {
+    // Iterative DFS over the tree with the context's workspace, written as first, ..., last.
+    // If the path does not fit, *length still receives the number of nodes it needs.
+    PathWorkspace* ws = &ctx->pathWork;
+    int count = 1, v;
+
+    if (!ctx->built)
+        return NET_ERROR_NO_NETWORK;
+    if (first >= ctx->tree.n || first < 0 || last >= ctx->tree.n || last < 0)
+        return NET_ERROR_INVALID_INPUT;
+    STAT_ADD(pathQueries, 1);
+
+    if (first != last) {
+        startPathQuery(ws);
+        if (Findpathit(&ctx->tree, ws, first, last) == NULL)
+            return NET_ERROR_NOT_CONNECTED;
+        for (v = last; v != first; v = ws->parent[v])
+            count++;
+    }
+
+    *length = count;
+    if (count > capacity)
+        return NET_ERROR_BUFFER_TOO_SMALL;
+    for (v = last; v != first; v = ws->parent[v])
+        path[--count] = v;
+    path[0] = first;
+    return NET_OK;
+}
+
+const char* netStatusText(NetStatus status) {
+    // The messages the command-line program prints for the same conditions, where it has one.
+    const char* texts[] = { "ok", "memory error", "invalid input", "Cannot build Prim",
+        "no network loaded", "path buffer too small" };
+
+    if ((int)status < 0 || (int)status > NET_ERROR_BUFFER_TOO_SMALL)
+        return "unknown status";
+    return texts[status];
+}
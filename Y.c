@@ -0,0 +1,210 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // Exposes writev() under strict ISO C modes.
+#endif
+#include "pro.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+void flushOutput(OutputBuffer* out, FILE* file, const char* path) {
+    // Hands the buffered bytes to the file in one fwrite and empties the buffer.
+    if (fwrite(out->data, 1, out->len, file) != out->len) {
+        printf("cannot write %s", path);
+        exit(1);
+    }
+    out->len = 0;
+}
+
+FILE* openExport(const char* path, OutputBuffer* out) {
+    // Opens an export file and its output buffer; stdio's own buffering is turned off,
+    // since every write is already a large block.
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("cannot open %s", path);
+        exit(1);
+    }
+    setvbuf(file, NULL, _IONBF, 0);
+    out->data = NULL;
+    out->len = out->cap = 0;
+    reserveOutput(out, EXPORT_BLOCK_SIZE + EXPORT_LINE_MAX);
+    return file;
+}
+
+void closeExport(FILE* file, OutputBuffer* out, const char* path) {
+    // Writes what is left and closes the file.
+    flushOutput(out, file, path);
+    free(out->data);
+    if (fclose(file) != 0) {
+        printf("cannot write %s", path);
+        exit(1);
+    }
+}
+
+void exportParentsText(const char* path, int* Prim, int n) {
+    // The node count, then the parent of every node (-1 for a root), one per line.
+    OutputBuffer out;
+    FILE* file = openExport(path, &out);
+    char* p = putLong(out.data, n, '\n');
+
+    for (int v = 0; v < n; v++) {
+        p = putLong(p, Prim[v], '\n');
+        if ((size_t)(p - out.data) >= EXPORT_BLOCK_SIZE) {
+            out.len = (size_t)(p - out.data);
+            flushOutput(&out, file, path);
+            p = out.data;
+        }
+    }
+    out.len = (size_t)(p - out.data);
+    closeExport(file, &out, path);
+}
+
+void exportTreeEdgesText(const char* path, int* Prim, int* parentCost, int n) {
+    // The tree edges with their costs in the program's input format (nodes, edge count,
+    // then "a b cost" lines), so an exported MST can be read back like any network.
+    OutputBuffer out;
+    FILE* file = openExport(path, &out);
+    int edges = 0, v;
+    char* p;
+
+    for (v = 0; v < n; v++)
+        if (Prim[v] != -1)
+            edges++;
+    p = putLong(out.data, n, '\n');
+    p = putLong(p, edges, '\n');
+    for (v = 0; v < n; v++) {
+        if (Prim[v] == -1)
+            continue;
+        p = putLong(p, Prim[v], ' ');
+        p = putLong(p, v, ' ');
+        p = putLong(p, parentCost[v], '\n');
+        if ((size_t)(p - out.data) >= EXPORT_BLOCK_SIZE) {
+            out.len = (size_t)(p - out.data);
+            flushOutput(&out, file, path);
+            p = out.data;
+        }
+    }
+    out.len = (size_t)(p - out.data);
+    closeExport(file, &out, path);
+}
+
+void exportMstBinary(const char* path, int* Prim, int* parentCost, int n) {
+    // Header, parent array and parent-edge costs. On POSIX systems the three parts go out
+    // in one gathered writev (repeated only after a partial write); elsewhere one fwrite each.
+    MstExportHeader header;
+    size_t bytes = sizeof(int) * (size_t)n;
+    int v;
+
+    memset(&header, 0, sizeof(header));
+    header.magic = MST_EXPORT_MAGIC;
+    header.version = MST_EXPORT_VERSION;
+    header.n = n;
+    for (v = 0; v < n; v++)
+        if (Prim[v] != -1)
+            header.edges++;
+
+#ifdef _WIN32
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("cannot open %s", path);
+        exit(1);
+    }
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(Prim, sizeof(int), n, file) != (size_t)n ||
+        fwrite(parentCost, sizeof(int), n, file) != (size_t)n ||
+        fclose(file) != 0) {
+        printf("cannot write %s", path);
+        exit(1);
+    }
+#else
+    struct iovec parts[3];
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644), first = 0;
+
+    if (fd < 0) {
+        printf("cannot open %s", path);
+        exit(1);
+    }
+    parts[0].iov_base = &header;
+    parts[0].iov_len = sizeof(header);
+    parts[1].iov_base = Prim;
+    parts[1].iov_len = bytes;
+    parts[2].iov_base = parentCost;
+    parts[2].iov_len = bytes;
+    while (first < 3) {
+        ssize_t written = writev(fd, parts + first, 3 - first);
+        if (written < 0) {
+            printf("cannot write %s", path);
+            exit(1);
+        }
+        // Skip what was written: whole parts first, then the start of the next one.
+        while (first < 3 && (size_t)written >= parts[first].iov_len)
+            written -= (ssize_t)parts[first++].iov_len;
+        if (first < 3) {
+            parts[first].iov_base = (char*)parts[first].iov_base + written;
+            parts[first].iov_len -= (size_t)written;
+        }
+    }
+    if (close(fd) != 0) {
+        printf("cannot write %s", path);
+        exit(1);
+    }
+#endif
+}
+
+long long exportPathsBinary(PathIndex* index, Reader* in, const char* path) {
+    // Answers "first last" pairs until the input ends and writes every path as a record:
+    // its node count, then the nodes from first to last, as 32-bit ints. A count of 0 means
+    // NO PATH and -1 an invalid query (an id out of range, or a token that is not a number). Records are collected in one buffer and written in blocks.
+    PathExportHeader header;
+    OutputBuffer out;
+    FILE* file = openExport(path, &out);
+    int* scratch = (int*)allocOrExit(sizeof(int) * ((size_t)index->n + 1));
+    long long answered = 0;
+    int first, last, lca, v, count;
+
+    memset(&header, 0, sizeof(header));
+    header.magic = PATH_EXPORT_MAGIC;
+    header.version = PATH_EXPORT_VERSION;
+    header.n = index->n;
+    memcpy(out.data, &header, sizeof(header));
+    out.len = sizeof(header);
+
+    while (readQuery(in, &first, &last)) {
+        answered++;
+        if (first >= index->n || first < 0 || last >= index->n || last < 0)
+            count = -1;
+        else if ((lca = lowestCommonAncestor(index, first, last)) == -1)
+            count = 0;
+        else {
+            // Upward half in order, downward half reversed behind it.
+            count = 0;
+            for (v = first; v != lca; v = index->up[v])
+                scratch[count++] = v;
+            scratch[count++] = lca;
+            int split = count;
+            for (v = last; v != lca; v = index->up[v])
+                scratch[count++] = v;
+            for (int i = split, j = count - 1; i < j; i++, j--) {
+                int swap = scratch[i];
+                scratch[i] = scratch[j];
+                scratch[j] = swap;
+            }
+        }
+
+        reserveOutput(&out, sizeof(int) * (1 + (size_t)(count > 0 ? count : 0)));
+        memcpy(out.data + out.len, &count, sizeof(int));
+        out.len += sizeof(int);
+        if (count > 0) {
+            memcpy(out.data + out.len, scratch, sizeof(int) * (size_t)count);
+            out.len += sizeof(int) * (size_t)count;
+        }
+        if (out.len >= EXPORT_BLOCK_SIZE)
+            flushOutput(&out, file, path);
+    }
+
+    closeExport(file, &out, path);
+    free(scratch);
+    return answered;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// Embeddable interface: build and query many networks in one process through a reusable
+// context. Nothing here prints or ends the process; every call reports a NetStatus.
+
+// The only symbols a shared build exports: the library is compiled with -fvisibility=hidden
+// (GCC, Clang), or as a DLL with NET_BUILD_DLL defined (MSVC), which keeps every internal
+// function and table out of the caller's namespace.
+#if defined(_WIN32) && defined(NET_BUILD_DLL)
+#define NET_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(NET_USE_DLL)
+#define NET_API __declspec(dllimport)
+#elif defined(__GNUC__)
+#define NET_API __attribute__((visibility("default")))
+#else
+#define NET_API
+#endif
+
+// Opaque handle; its buffers grow to the largest network loaded and are then reused.
+typedef struct NetContext NetContext;
+
+typedef enum {
+    NET_OK = 0,
+    NET_ERROR_MEMORY,           // An allocation failed
+    NET_ERROR_INVALID_INPUT,    // Bad count, node id out of range, self loop or negative cost
+    NET_ERROR_NOT_CONNECTED,    // The network has no spanning tree
+    NET_ERROR_NO_NETWORK,       // Called before a successful netLoad / netBuildMst
+    NET_ERROR_BUFFER_TOO_SMALL  // The caller's path buffer is shorter than the path
+} NetStatus;
+
+NET_API NetContext* netCreate(void); // Creates an empty context, or returns NULL if memory runs out.
+NET_API void netDestroy(NetContext* ctx); // Frees a context and all its buffers.
+NET_API NetStatus netLoad(NetContext* ctx, int n, const int* edges, int m); // Loads n nodes and m (a, b, cost) triples.
+NET_API NetStatus netBuildMst(NetContext* ctx); // Builds the MST of the loaded network (Prim).
+NET_API NetStatus netParents(NetContext* ctx, const int** parents); // The MST as a parent array (root -1).
+NET_API NetStatus netMstCost(NetContext* ctx, long long* total); // Total cost of the MST.
+NET_API NetStatus netFindPath(NetContext* ctx, int first, int last, int* path, int capacity, int* length); // MST path first..last.
+NET_API const char* netStatusText(NetStatus status); // Short description of a status.
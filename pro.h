@@ -14,25 +14,246 @@
 #include <math.h>
 #include <limits.h>
 
+#include "netlib.h"
+
+// ---- Memory Arenas ----
+
+#define ARENA_ALIGN         16          // Alignment of every arena allocation
+#define ARENA_DEFAULT_BLOCK (1 << 20)   // Block size used when none is requested
+
+// One chunk of arena memory; allocations are carved from `data` front to back.
+typedef struct arena_block {
+    struct arena_block* next;
+    size_t size; // Usable bytes in `data`
+    size_t used; // Bytes handed out so far
+    _Alignas(ARENA_ALIGN) unsigned char data[];
+} ArenaBlock;
+
+// Bump allocator: objects with a shared lifetime are freed together by freeArena.
+typedef struct {
+    ArenaBlock* head;  // Most recent block
+    size_t blockSize;  // Minimum size of a new block
+    size_t bytes;      // Total bytes handed out
+} Arena;
+
 // ---- Graph Representation ----
 
-// Defines an edge in the graph with a neighbor node and associated cost.
+// Defines an input connection between two nodes with its associated cost.
+// During ingestion `a` < `b`, so both directions of a connection share one key.
 typedef struct {
+    int a;
+    int b;
+    int cost;
+} InputEdge;
+
+// Compressed sparse row (CSR) graph: the edges of node v are stored contiguously
+// at indices offsets[v] .. offsets[v + 1] - 1 of `neighbors` and `costs`.
+typedef struct {
+    int n;          // Number of nodes
+    int m;          // Number of stored edges (every connection appears once per direction)
+    int* offsets;   // n + 1 entries, offsets[n] == m
+    int* neighbors; // Neighbor of each stored edge, ascending within a node
+    int* costs;     // Cost of each stored edge, parallel to `neighbors`
+    Arena* arena;   // Arena owning the arrays, or NULL when they live in a file mapping
+    void* mapping;  // File mapping the arrays live in, or NULL
+    size_t mappingSize;
+} Graph;
+
+// ---- Compressed Adjacency ----
+
+// CSR graph with every edge list packed into bytes: each edge is a zigzag varint of the gap to
+// the previous neighbor (the node itself for the first edge), followed by a varint cost.
+// Node v's edges occupy data[offsets[v]] .. data[offsets[v + 1] - 1].
+typedef struct {
+    int n;                // Number of nodes
+    int m;                // Number of stored edges, as in Graph
+    size_t* offsets;      // n + 1 byte offsets into `data`
+    unsigned char* data;  // Encoded edge lists
+    Arena* arena;         // Owns the struct and its arrays
+} CompressedGraph;
+
+// Cursor over one node's encoded edges; `neighbor` and `cost` hold the edge just decoded.
+typedef struct {
+    const unsigned char* pos;
+    const unsigned char* end;
     int neighbor;
     int cost;
-} Edge;
+} EdgeIterator;
+
+// The decoder runs once per edge in Prim's inner loop, so it is defined here to be inlined.
+static inline unsigned int readVarint(const unsigned char** pos) {
+    // LEB128: seven bits per byte, low bits first; one-byte values take the fast path.
+    const unsigned char* p = *pos;
+    unsigned int value = *p++, shift = 7;
 
-// Represents a node in the adjacency list (linked list of edges).
-typedef struct edge_node {
-    Edge e;
-    struct edge_node* next;
-} EdgeNode;
+    if (value >= 0x80) {
+        value &= 0x7F;
+        do {
+            value |= (unsigned int)(*p & 0x7F) << shift;
+            shift += 7;
+        } while (*p++ >= 0x80);
+    }
+    *pos = p;
+    return value;
+}
 
-// Represents an adjacency list for a given graph node.
+static inline void beginEdges(const CompressedGraph* graph, int v, EdgeIterator* it) {
+    // Positions the iterator before node v's first edge.
+    it->pos = graph->data + graph->offsets[v];
+    it->end = graph->data + graph->offsets[v + 1];
+    it->neighbor = v;
+    it->cost = 0;
+}
+
+static inline bool nextEdge(EdgeIterator* it) {
+    // Decodes the next edge; returns false after the last one.
+    unsigned int gap;
+
+    if (it->pos == it->end)
+        return false;
+    gap = readVarint(&it->pos);
+    it->neighbor += (gap & 1) ? -(int)(gap >> 1) - 1 : (int)(gap >> 1);
+    it->cost = (int)readVarint(&it->pos);
+    return true;
+}
+
+// ---- Binary Graph File ----
+
+#define GRAPH_FILE_MAGIC   0x4E525047u // "GPRN" in little-endian byte order
+#define GRAPH_FILE_VERSION 1u
+
+#define GRAPH_FLAG_SORTED  0x1u // Neighbors are ascending within every node
+
+// Fixed 32-byte header, followed by offsets[n + 1], neighbors[m] and costs[m] as 32-bit ints.
 typedef struct {
-    EdgeNode* head;
-    EdgeNode* tail;
-} EdgeList;
+    unsigned int magic;
+    unsigned int version;
+    unsigned int flags;
+    int n;               // Number of nodes
+    int m;               // Number of stored edges
+    unsigned int reserved[3];
+} GraphFileHeader;
+
+// ---- Parallel MST ----
+
+// Selects the algorithm that turns the network into the `Prim` parent array.
+typedef enum {
+    ENGINE_PRIM,    // Sequential Prim with the indexed heap
+    ENGINE_BORUVKA, // Multi-threaded Boruvka rounds
+    ENGINE_KRUSKAL, // Radix-sorted edges and a union-find
+    ENGINE_AUTO,    // Prim or Kruskal, chosen from V and E by chooseEngine
+    ENGINE_DENSE    // O(V^2) Prim over a cost matrix with SIMD kernels
+} MstEngine;
+
+#define RADIX_BITS          11                // Cost digit width of the Kruskal radix sort
+#define RADIX_BUCKETS       (1 << RADIX_BITS)
+#define KRUSKAL_MAX_DENSITY 16                // Auto mode uses Kruskal while E <= 16 * V
+#define STREAM_NODE_BYTES   (3 * sizeof(int) + 2 * sizeof(InputEdge)) // Union-find, radix counts and two forests per node
+#define STREAM_EDGE_BYTES   (3 * sizeof(InputEdge)) // Chunk edge plus its two radix-sort buffers
+#define STREAM_MIN_CHUNK    4096              // Smallest chunk, whatever the budget
+#define STREAM_QSORT_RATIO  16                // Chunks under n / 16 edges skip the O(n) radix counts
+#define DENSE_MIN_FILL      8                 // Prim uses the cost matrix while E >= V * V / 8
+#define DENSE_IN_TREE       (-1)              // Dense Prim key of a node already in the tree
+
+// Relaxes one cost-matrix row into the dense Prim keys, resets the row and returns the next node (-1 when done).
+typedef int (*DenseKernel)(int* key, int* parent, int* row, int n, int u);
+
+// Work item of runParallel: called once per worker with ids 0 .. workers - 1.
+typedef void (*ParallelTask)(void* arg, int id);
+
+// Step run by the last worker to reach a barrier, alone, before the others are released.
+typedef void (*SerialStep)(void* arg);
+
+// Reusable barrier for a fixed number of workers; its fields depend on the platform (I.c).
+typedef struct Barrier Barrier;
+
+// State shared by the workers of one Boruvka round.
+typedef struct {
+    Graph* graph;
+    int* parent;          // Hook forest over the nodes; a component root points at itself
+    int* jumped;          // Second buffer of the pointer-jumping steps
+    int* label;           // Component root of every node for this round
+    int* bestEdge;        // Cheapest edge leaving each node's component, or -1
+    volatile int* compFrom; // Node holding the cheapest edge of each component, or -1
+    InputEdge* tree;      // Tree edges found so far
+    volatile int count;   // Entries in `tree`
+    volatile int added;   // Edges added in the current round
+    volatile int changed; // Workers whose jump step moved a pointer
+    bool done;            // Set at a barrier: the last round added no edge
+    bool jumping;         // Set at a barrier: the last jump step moved a pointer
+    int* split;           // Node range of every worker (workers + 1 entries)
+    int workers;
+    Barrier* barrier;     // Separates the phases of the workers, which live for the whole build
+} BoruvkaRound;
+
+// ---- Path Query Index ----
+
+// Binary-lifting index over the MST, built once from the Prim parent array.
+typedef struct {
+    int n;         // Number of nodes
+    int levels;    // Number of lifting levels (2^levels >= n)
+    int* depth;    // Distance of every node from its tree root
+    int* root;     // Tree root of every node
+    int* up;       // up[k * n + v] is the 2^k-th ancestor of v (a root is its own ancestor)
+    int* scratch;  // Reusable buffer for printing the downward half of a path
+    Arena* arena;  // Owns the index and all its tables, except those in `mapping`
+    void* mapping; // Cache file the depth, root and lifting tables live in, or NULL
+    size_t mappingSize;
+} PathIndex;
+
+// Bottleneck and path-cost tables on top of a PathIndex (which keeps the lifting jumps).
+typedef struct {
+    PathIndex* index;    // Depth, root and ancestor tables
+    int* maxUp;          // maxUp[k * n + v] is the most expensive edge on the 2^k edges above v
+    long long* rootCost; // Total edge cost from every node up to its tree root
+    Arena* arena;        // Owns the struct and both tables
+} CostIndex;
+
+// ---- MST Cache ----
+
+#define MST_CACHE_MAGIC   0x54534D4Eu // "NMST" in little-endian byte order
+#define MST_CACHE_VERSION 1u
+
+// Header of a cache file, followed by the Prim, depth and root arrays (n ints each)
+// and the lifting table (levels * n ints), all in native byte order.
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    int n;
+    int levels;
+    unsigned long long key;       // cacheKey of the network and options
+    unsigned int reserved[2];
+} MstCacheHeader;
+
+// ---- Path Search Workspace ----
+
+// Reusable DFS state. Entries of `color` and `parent` are valid only where stamp[v] == epoch,
+// so a new query starts by bumping the epoch instead of clearing O(n) arrays.
+typedef struct {
+    int n;                // Number of nodes
+    unsigned int epoch;   // Stamp of the current query
+    unsigned int* stamp;  // Query that last touched each node
+    int* color;           // WHITE / GRAY / BLACK, valid when stamped
+    int* parent;          // DFS parent, valid when stamped
+    int* stack;           // Explicit DFS stack (also used to reverse printed paths)
+    int* edge;            // Next edge to examine for each stack entry
+    int* component;       // Optional component labels for O(1) "NO PATH" answers, or NULL
+    Arena* arena;         // Owns the workspace and its arrays
+} PathWorkspace;
+
+// ---- Text Input ----
+
+#define READER_BLOCK_SIZE (1 << 20) // Bytes requested from the input per read
+
+// Block-buffered reader with a hand-written integer tokenizer, used instead of scanf.
+typedef struct {
+    int fd;         // Input file descriptor
+    char* buffer;   // Current block
+    size_t len;     // Bytes in the current block
+    size_t pos;     // Next unread byte
+    bool eof;       // End of input was reached
+    bool badToken;  // The last readInt skipped a token that is not a number
+} Reader;
 
 // ---- Prim's Algorithm Structures ----
 
@@ -42,56 +263,476 @@ typedef struct {
     int min;      // Minimum cost to reach this node
 } Candidate;
 
-// Doubly linked list node for Prim's priority queue.
-typedef struct candidate_node {
-    Candidate c;
-    struct candidate_node* next;
-    struct candidate_node* prev;
-} CandidateNode;
+// Indexed binary min-heap used as Prim's priority queue.
+// `location[v]` holds the heap position of node v, or -1 once it was extracted.
+typedef struct {
+    Candidate* heap; // Heap-ordered candidates, smallest (min, computer) at index 0
+    int* location;   // Node identifier -> heap position
+    int size;        // Number of candidates still in the heap
+} CandidateHeap;
+
+// Caller-owned buffers for one Prim run (at least n entries each), reusable across runs.
+typedef struct {
+    int* minArr;            // Cheapest known edge into every node
+    bool* inT;              // Nodes already in the tree
+    CandidateHeap priority; // Nodes not in the tree yet
+} PrimWorkspace;
+
+// ---- Spanning Forest ----
+
+// Connected components of a graph, numbered in order of their smallest node.
+typedef struct {
+    int count;   // Number of components
+    int* label;  // Component of every node
+    int* root;   // Smallest node of every component
+    int* start;  // Prefix sums of component sizes (count + 1 entries)
+} Components;
+
+// State shared by the workers building a minimum spanning forest.
+typedef struct {
+    Graph* graph;
+    Components* comps;
+    int* prim;          // Output parent array
+    int* minArr;        // Per-node minimum edge weights
+    bool* inT;          // Per-node "already in the tree" flags
+    int* location;      // Per-node heap position (-1 when not in a heap)
+    Candidate* slots;   // Heap storage, one slice of `start` per component
+    volatile int next;  // Next unclaimed component
+} ForestBuild;
+
+// ---- Incremental MST ----
+
+// MST that accepts new or cheaper edges without a rebuild. It patches the caller's `Prim`
+// array in place; `cost` holds the weight of every tree edge (v, parent[v]).
+typedef struct {
+    int n;
+    int* parent;          // The `Prim` parent array being maintained
+    int* cost;            // Cost of the edge from every node to its parent
+    unsigned int epoch;   // Stamp of the current path walk
+    unsigned int* stamp;  // Walk that last reached each node
+    int* side;            // Which endpoint's walk reached it (0 or 1)
+    Arena* arena;         // Owns everything except `parent`
+} DynamicMst;
+
+// ---- Shortest Paths ----
+
+#define DIST_INFINITY LLONG_MAX // Distance of a node no source reaches
+
+// Dijkstra heap entry. Path costs are sums of edge costs and can pass INT_MAX, so the key is
+// 64-bit; otherwise this is the same indexed heap as CandidateHeap.
+typedef struct {
+    long long dist; // Tentative distance from the nearest source
+    int node;       // Node identifier
+} DistanceCandidate;
+
+// Indexed binary min-heap ordered by (dist, node). `location[v]` is v's heap position,
+// DIST_UNSEEN before v is reached in the current run and DIST_SETTLED once it is extracted.
+typedef struct {
+    DistanceCandidate* heap;
+    int* location;
+    int size;
+} DistanceHeap;
+
+#define DIST_UNSEEN  (-1)
+#define DIST_SETTLED (-2)
 
-// Doubly linked list for managing candidates in Prim's priority queue.
+// Per-thread Dijkstra state, reused across runs.
 typedef struct {
-    CandidateNode* head;
-    CandidateNode* tail;
-} CandidateList;
+    int n;
+    DistanceHeap heap;
+    Arena* arena;       // Owns the workspace and its arrays
+} DijkstraWorkspace;
 
-int main(); // Forward declaration of the main function.
+// State shared by the workers of a many-sources run.
+typedef struct {
+    Graph* graph;
+    const int* sources;
+    int count;
+    long long* dist;    // count * n distances, one row per source
+    int* pred;          // count * n predecessors, one row per source
+    volatile int next;  // Next unclaimed source
+} ManySources;
+
+// ---- Vertex Reordering ----
+
+// Relabeling applied to the network before the MST is built.
+typedef enum {
+    REORDER_NONE,
+    REORDER_BFS,    // Breadth-first order from node 0
+    REORDER_RCM,    // Reverse Cuthill-McKee (BFS from low-degree nodes, reversed)
+    REORDER_DEGREE  // Descending degree
+} ReorderKind;
+
+// ---- Query Service ----
+
+#define QUERY_BATCH        8192      // Most queries answered together
+#define QUERY_MALFORMED    INT_MIN   // Both ends of a query with a token that is not a number
+#define QUERY_PARALLEL_MIN 512       // Smaller batches are answered on the calling thread
+#define OUTPUT_BUFFER_SIZE (1 << 16) // Initial size of every worker's output buffer
+
+// Growable byte buffer that answers are formatted into before one fwrite.
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+} OutputBuffer;
+
+// Queries collected by the server and the per-worker state that answers them.
+typedef struct {
+    PathIndex* index;
+    CostIndex* costs;       // When set, queries are answered with "bottleneck total"
+    int* first;             // QUERY_BATCH start nodes
+    int* last;              // QUERY_BATCH end nodes
+    int count;              // Pending queries
+    int threads;            // Worker pool size
+    int workers;            // Workers used for the current batch
+    OutputBuffer* outputs;  // One buffer per worker
+} QueryBatch;
+
+// ---- Library Context ----
+
+// State behind the opaque NetContext of netlib.h. The graphs point into the context's own
+// buffers, which only grow, so loading a network no larger than an earlier one allocates nothing.
+struct NetContext {
+    bool loaded;             // `net` holds a valid network
+    bool built;              // `tree`, `prim` and `parentCost` hold its MST
+    int nodeCapacity;        // Nodes the per-node buffers hold, -1 before the first netLoad
+    int edgeCapacity;        // Connections the per-edge buffers hold, -1 before the first netLoad
+    Graph net;               // Loaded network (CSR)
+    Graph tree;              // MST of `net` (CSR, both directions)
+    InputEdge* edges;        // Connections being loaded
+    InputEdge* sorted;       // Radix-sort buffer
+    int* count;              // n + 1 radix counters, then CSR write cursors
+    int* prim;               // MST parent array
+    int* parentCost;         // Cost of every node's parent edge
+    PrimWorkspace primWork;  // Prim's keys, tree flags and heap
+    PathWorkspace pathWork;  // DFS state for path queries
+};
+
+// ---- Export ----
+
+#define EXPORT_BLOCK_SIZE (1 << 20) // Export files are written in blocks of about this size
+#define EXPORT_LINE_MAX   64        // Longest text line of an export (three numbers)
+
+#define MST_EXPORT_MAGIC    0x58544D4Eu // "NMTX" in little-endian byte order
+#define MST_EXPORT_VERSION  1u
+#define PATH_EXPORT_MAGIC   0x58485450u // "PTHX" in little-endian byte order
+#define PATH_EXPORT_VERSION 1u
+
+// Header of a binary MST export, followed by the Prim array and the parent-edge costs
+// (n ints each, a root has parent -1 and cost 0), in native byte order.
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    int n;
+    int edges;  // Tree edges (nodes that are not roots)
+} MstExportHeader;
+
+// Header of a binary path export, followed by one record per query: a node count
+// (0 = NO PATH, -1 = invalid query) and that many node ids, in native byte order.
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    int n;
+    int reserved;
+} PathExportHeader;
+
+// ---- Benchmarks ----
+
+#define BENCH_MAX_COST 1000000 // Costs of generated edges are uniform in [0, BENCH_MAX_COST]
+
+// Shape of a generated benchmark graph.
+typedef enum {
+    GRAPH_RANDOM,   // Random spanning tree plus uniformly random extra edges
+    GRAPH_GRID,     // Near-square 2D lattice
+    GRAPH_POWERLAW, // Preferential attachment (scale-free degrees)
+    GRAPH_CHAIN     // A single path, the deepest possible tree
+} GraphKind;
+
+// Parameters of one benchmark run (--bench and its options).
+typedef struct {
+    GraphKind kind;
+    int nodes;
+    int degree;                 // Target average degree (random and power-law graphs)
+    unsigned long long seed;
+    int queries;                // Path queries per query phase
+    MstEngine engine;
+    bool forest;
+    bool compressed;            // Run Prim on the compressed adjacency
+    bool shuffle;               // Randomly permute the generated node ids
+    ReorderKind reorder;        // Relabeling before the MST
+    int threads;
+} BenchConfig;
+
+// ---- Instrumentation ----
+
+// Counters are compiled in only when NET_STATS is defined (e.g. -DNET_STATS); otherwise every
+// STAT_* macro expands to nothing and its arguments are never evaluated.
+#define STATS_MAX_PHASES 16
+
+// Hot-path counters and phase timings, dumped as JSON by --stats.
+typedef struct {
+    long long heapPops;           // deleteMin calls
+    long long siftDownSteps;      // Heap levels scanned by deleteMin
+    long long decreaseKeyCalls;
+    long long decreaseKeyLowered; // decreaseKey calls that actually lowered a key
+    long long radixMoves;         // Edges moved by the ingest radix sort
+    long long segmentShifts;      // Insertion-sort shifts in sortSegment
+    long long duplicateChecks;    // Neighbouring-key comparisons while removing repeated connections
+    long long edgeProbes;         // Binary-search probes in findEdgeCost
+    long long allocations;
+    long long allocatedBytes;
+    long long pathQueries;        // Path queries of every kind (DFS, indexed, cost)
+    long long dfsQueries;         // Queries that ran the path DFS
+    long long dfsNodesVisited;    // Nodes stamped by the path DFS
+    long long indexedPathSteps;   // Parent steps taken by indexed path queries
+    int phaseCount;
+    const char* phaseNames[STATS_MAX_PHASES];
+    double phaseSeconds[STATS_MAX_PHASES];
+} NetStats;
+
+#ifdef NET_STATS
+extern NetStats netStats;
+#define STAT_ADD(counter, amount)   atomicFetchAdd64(&netStats.counter, (amount))
+#define STAT_PHASE_START(start)     double start = nowSeconds()
+#define STAT_PHASE_END(name, start) statsPhase((name), nowSeconds() - (start))
+#else
+#define STAT_ADD(counter, amount)   ((void)0)
+#define STAT_PHASE_START(start)     ((void)0)
+#define STAT_PHASE_END(name, start) ((void)0)
+#endif
+
+int main(int argc, char* argv[]); // Forward declaration of the main function.
+bool parseGraphKind(const char* name, GraphKind* kind); // Parses a --bench graph kind.
+bool parseByteSize(const char* text, size_t* bytes); // Parses a size such as 512M.
+bool parseReorder(const char* name, ReorderKind* kind); // Parses a --reorder argument.
 
 // ---- Function Declarations ----
 
 // **A: Graph Construction & Management**
-EdgeNode* Make_list_With_Dummy(); // Creates an adjacency list with dummy head & tail nodes.
-EdgeNode* Create_New_Node(int neighbor, int cost); // Creates a new edge node.
-EdgeList* build_net(int n); // Constructs the network graph.
-void Sort_List(EdgeList* net, EdgeNode* node); // Inserts an edge into the adjacency list in sorted order.
-void printNet(EdgeList* list, int len); // Prints the entire graph.
-void print_list_it(EdgeNode* head); // Iterates through an adjacency list and prints its contents.
-void freeEdgeList(EdgeList* Net, int n); // Frees allocated memory for the graph.
-bool Check_Edge(EdgeList* net, int a, int b); // Check if the connection is already set.
+Graph* build_net(Reader* in, int n); // Constructs the network graph.
+void radixSortEdges(Arena* scratch, InputEdge* edges, int m, int n); // Stable sort of connections by (a, b) in O(m + n).
+void radixSortEdgesWith(InputEdge* edges, InputEdge* temp, int* count, int m, int n); // The same sort on caller buffers.
+int dedupeEdges(InputEdge* edges, int m); // Drops repeated connections of a sorted buffer, keeping the first.
+void reportDuplicates(int count); // Prints the duplicate-connection warning `count` times.
+Graph* edgesToGraph(Arena* scratch, InputEdge* edges, int m, int n); // Builds a CSR graph from sorted, unique connections.
+void fillGraph(Graph* graph, InputEdge* edges, int m, int* next); // Writes the CSR arrays of an existing graph.
+Graph* makeGraph(int n, int m); // Allocates a CSR graph and its arrays as one arena block.
+void sortSegment(Graph* graph, int v); // Sorts the edges of node v by neighbor (insertion sort).
+void printNet(Graph* graph); // Prints the entire graph.
+int findEdgeCost(Graph* graph, int u, int v); // Cost of the edge u - v (binary search), or -1.
+void freeGraph(Graph* graph); // Frees allocated memory for a CSR graph.
 
 // **B: Prim's Algorithm Functions**
-int* build_prim_tree(EdgeList Net[], int n); // Builds the Minimum Spanning Tree using Prim's Algorithm.
-int* buildPrim(int n); // Initializes the MST parent array.
-bool* buildIntList(int n); // Initializes a boolean array for tracking visited nodes.
-int* buildMinArr(int n); // Initializes an array for minimum edge weights.
-CandidateList* buildPriority(int vNum, EdgeList* Net, CandidateNode*** location); // Initializes the priority queue.
-void print_list_Com(CandidateNode* head); // Prints the priority queue for debugging.
-CandidateList* makeEmptyCandidList(); // Creates an empty candidate list for Prim's Algorithm.
-int deleteMin(CandidateList* priority, CandidateNode** location); // Removes the minimum-cost node from the priority queue.
-void decreaseKey(CandidateNode** location, int v, int minCost); // Updates a node's cost in the priority queue.
-void freeFun(int* minArr, bool* inT, CandidateNode** location, CandidateList* priority); // Frees allocated memory for Prim's Algorithm.
-void freeCandidateList(CandidateList* list); // Frees all memory allocated for the priority queue.
+int* build_mst(Graph* Net, MstEngine engine, int threads); // Builds the MST parent array with the chosen engine.
+bool parseEngine(const char* name, MstEngine* engine); // Parses an --engine argument.
+const char* engineName(MstEngine engine); // Name of an engine as accepted by --engine.
+int* build_prim_tree(Graph* Net); // Builds the Minimum Spanning Tree using Prim's Algorithm.
+bool primWithWorkspace(Graph* Net, PrimWorkspace* ws, int* prim); // Prim on caller buffers; false if disconnected.
+int* buildPrim(int n); // Initializes the MST parent array (owned by the caller).
+bool* buildIntList(Arena* arena, int n); // Initializes a boolean array for tracking visited nodes.
+int* buildMinArr(Arena* arena, int n); // Initializes an array for minimum edge weights.
+CandidateHeap* buildPriority(Arena* arena, int vNum); // Initializes the priority queue with every node at INT_MAX.
+void print_list_Com(CandidateHeap* priority); // Prints the priority queue for debugging.
+bool candidateLess(Candidate x, Candidate y); // Heap order: lower cost first, lower node id on ties.
+void siftUp(CandidateHeap* priority, int pos); // Moves a candidate towards the root until heap order holds.
+void siftDown(CandidateHeap* priority, int pos); // Moves a candidate towards the leaves until heap order holds.
+int deleteMin(CandidateHeap* priority); // Removes the minimum-cost node from the priority queue.
+void decreaseKey(CandidateHeap* priority, int v, int minCost); // Lowers a node's cost in the priority queue.
+void insertCandidate(CandidateHeap* priority, int v, int minCost); // Adds a node to the priority queue.
 
 // **C: Path Construction Functions**
-void addToEnd(EdgeList* ComPath, EdgeNode* newNode); // Adds a node to the end of an adjacency list.
-EdgeList* build_paths(int* Prim, int n); // Builds paths based on the MST from Prim's Algorithm.
+Graph* build_paths(int* Prim, int* parentCost, int n); // Builds paths based on the MST from Prim's Algorithm.
+void fillPaths(Graph* PrimPath, int* Prim, int* parentCost, int* next); // Writes the tree CSR into existing arrays.
+int* treeToPrim(InputEdge* tree, int count, int n); // Roots tree edges (any order; sorted in place) into a `Prim` array.
 
 // **D: Pathfinding Functions**
-void find_and_print_path(EdgeList* primpath, int size, int first, int last); // Finds and prints the shortest path between two nodes.
-int* Findpath(EdgeList* primpath, int* color, int* parent, int first, int last); // Wrapper function for recursive pathfinding.
-int* Findpathrec(EdgeList* primpath, int* color, int* parent, int first, int last); // Recursive function to find a path.
-int printpathrec(int first, int last, int* parent); // Recursively prints a found path.
+PathWorkspace* makePathWorkspace(int n); // Allocates a reusable search workspace for n nodes.
+void labelPathComponents(PathWorkspace* ws, int* Prim); // Tree labels for O(1) NO PATH answers in a forest.
+void freePathWorkspace(PathWorkspace* ws); // Frees a search workspace.
+void visitNode(PathWorkspace* ws, int v, int color, int parent); // Records a node for the current query.
+void startPathQuery(PathWorkspace* ws); // Invalidates the previous query's stamps.
+int nodeColor(PathWorkspace* ws, int v); // Color of a node in the current query (WHITE if untouched).
+void find_and_print_path(Graph* primpath, PathWorkspace* ws, int first, int last); // Finds and prints the path between two nodes.
+int* Findpath(Graph* primpath, PathWorkspace* ws, int first, int last); // Wrapper function for the iterative search.
+int* Findpathit(Graph* primpath, PathWorkspace* ws, int first, int last); // Iterative DFS with an explicit stack.
+int printpathit(PathWorkspace* ws, int first, int last); // Iteratively prints a found path.
+
+// **E: Binary Graph Files**
+void saveGraph(Graph* graph, const char* path); // Writes a graph in the binary file format.
+Graph* loadGraph(const char* path); // Maps a binary graph file; the arrays point straight into it.
+bool validGraph(Graph* graph); // Checks the CSR invariants every pass relies on.
+void* mapFile(const char* path, size_t* size); // Maps a whole file read-only.
+void unmapFile(void* mapping, size_t size); // Releases a mapping made by mapFile.
+
+// **F: Text Input**
+Reader* openReader(FILE* file); // Creates a block reader over an open file.
+bool refillReader(Reader* in); // Reads the next block; returns false at end of input.
+bool readInt(Reader* in, int* value); // Parses the next integer; false at end of input or on a skipped bad token.
+bool isTokenEnd(char c); // True for the whitespace that separates tokens.
+void skipLine(Reader* in); // Drops the rest of the current line.
+bool inputPending(Reader* in); // True if unread input is already buffered.
+void closeReader(Reader* in); // Frees a reader (the file itself stays open).
+
+// **G: Memory Arenas**
+Arena* makeArena(size_t blockSize); // Creates an empty arena.
+void* allocOrExit(size_t size); // malloc that reports "memory error" and exits on failure.
+void* reallocOrExit(void* memory, size_t size); // realloc counterpart of allocOrExit.
+void* arenaAlloc(Arena* arena, size_t size); // Allocates aligned memory from the arena.
+void* arenaCalloc(Arena* arena, size_t count, size_t size); // Allocates zeroed memory from the arena.
+void freeArena(Arena* arena); // Frees the arena and everything allocated from it.
+
+// **H: Indexed Path Queries**
+PathIndex* buildPathIndex(int* Prim, int n); // Builds depth and binary-lifting tables for the MST.
+int lowestCommonAncestor(PathIndex* index, int u, int v); // LCA in O(log n), -1 across trees.
+void printIndexedPath(PathIndex* index, int first, int last); // Prints the tree path in O(log n + length).
+void freePathIndex(PathIndex* index); // Frees the index and its tables.
+
+// **I: Threads**
+int cpuCount(void); // Number of online processors.
+void runParallel(int workers, ParallelTask task, void* arg); // Runs a task on `workers` threads and joins them.
+int atomicFetchAdd(volatile int* value, int delta); // Atomic add; returns the previous value.
+long long atomicFetchAdd64(volatile long long* value, long long delta); // 64-bit atomicFetchAdd.
+int atomicLoad(volatile int* value); // Atomic read.
+bool atomicCompareExchange(volatile int* value, int* expected, int desired); // CAS; reloads `expected` on failure.
+Barrier* makeBarrier(int workers); // Creates a barrier for `workers` threads.
+void waitBarrier(Barrier* barrier, SerialStep step, void* arg); // Waits for all workers; the last runs `step`.
+void freeBarrier(Barrier* barrier); // Destroys a barrier no worker is waiting on.
+
+// **J: Parallel Boruvka MST**
+int* build_boruvka_tree(Graph* Net, int threads); // Builds the MST with parallel Boruvka rounds.
+void splitByEdges(Graph* Net, int* split, int workers); // Splits the nodes into edge-balanced ranges.
+bool mstEdgeLess(Graph* Net, int u1, int j1, int u2, int j2); // Total edge order: cost, low end, high end.
+void boruvkaWorker(void* arg, int id); // Worker: runs every phase of every round, between barriers.
+void boruvkaScan(void* arg, int id); // Worker: cheapest outgoing edge of every node in the range.
+void boruvkaPick(void* arg, int id); // Worker: cheapest pick per component, by compare-and-swap.
+void boruvkaHook(void* arg, int id); // Worker: hooks component roots along their picks.
+void boruvkaJump(void* arg, int id); // Worker: one pointer-jumping step over the hook forest.
+void boruvkaRelabel(void* arg, int id); // Worker: refreshes component labels after a merge.
+void boruvkaHooked(void* arg); // Serial step: ends the build or starts the next round's jumps.
+void boruvkaJumped(void* arg); // Serial step: swaps the jump buffers and decides on another step.
+int findSet(int* parent, int v); // Union-find root with path halving.
+bool unionSets(int* parent, int* rank, int u, int w); // Union by rank; false if already joined.
+
+// **K: Kruskal MST**
+int* build_kruskal_tree(Graph* Net); // Builds the MST with Kruskal's algorithm.
+InputEdge* collectEdges(Arena* arena, Graph* Net, int* count); // Lists each connection once in (low, high) order.
+void radixSortByCost(Arena* scratch, InputEdge* edges, int m); // Stable radix sort of edges by cost.
+MstEngine chooseEngine(Graph* Net); // Picks Prim or Kruskal from the graph's density.
+
+// **L: Minimum Spanning Forest**
+Components* labelComponents(Arena* arena, Graph* Net); // Labels connected components in one linear pass.
+int* build_prim_forest(Graph* Net, int threads); // Builds one Prim tree per component, in parallel.
+void forestWorker(void* arg, int id); // Worker: builds trees for the components it claims.
+void primComponent(ForestBuild* build, int c); // Prim's Algorithm restricted to one component.
+
+// **M: Incremental MST**
+DynamicMst* makeDynamicMst(Graph* Net, int* Prim); // Starts maintaining an MST given as a `Prim` array.
+void freeDynamicMst(DynamicMst* dyn); // Frees the maintenance state (not the `Prim` array).
+bool markWalk(DynamicMst* dyn, int v, int side); // Stamps a node during an LCA walk.
+int dynamicLca(DynamicMst* dyn, int a, int b); // LCA in O(path length), -1 across trees.
+void evertPath(DynamicMst* dyn, int v, int stop); // Reverses parent pointers along v -> stop.
+int maxEdgeBelow(DynamicMst* dyn, int v, int lca); // Most expensive tree edge on v -> lca.
+bool updateMst(DynamicMst* dyn, int a, int b, int cost); // Applies a new or cheaper edge.
+
+// **N: Benchmarks**
+double nowSeconds(void); // Monotonic clock in seconds.
+long peakRssKb(void); // Peak resident set size so far, in KiB.
+unsigned long long nextRandom(unsigned long long* state); // splitmix64 step.
+int randomBelow(unsigned long long* state, int bound); // Random integer in [0, bound).
+void addBenchEdge(InputEdge* edges, int* count, int a, int b, unsigned long long* state); // Appends a random-cost edge.
+InputEdge* generateGraph(Arena* arena, BenchConfig* config, int* count); // Generates a seeded synthetic graph.
+void writeBenchInput(FILE* file, InputEdge* edges, int count, int n); // Writes a graph as program input text.
+void reportPhase(FILE* out, const char* phase, double seconds, long long items, const char* unit, bool last); // JSON phase record.
+int runBenchmark(BenchConfig* config); // Runs every phase on a generated graph and prints JSON results.
+
+// **O: Instrumentation**
+void statsPhase(const char* name, double seconds); // Records the wall time of a phase.
+void dumpStats(void); // Writes the counters as JSON to stderr (registered with atexit by --stats).
+
+// **P: Dense Prim**
+bool isDenseGraph(Graph* Net); // True when the cost-matrix Prim is the better choice.
+int* build_dense_prim_tree(Graph* Net); // O(V^2) Prim over a cost matrix; same result as build_prim_tree.
+int denseRelaxScalar(int* key, int* parent, int* row, int n, int u); // Portable relax-and-argmin kernel.
+int denseRelaxAvx2(int* key, int* parent, int* row, int n, int u); // AVX2 kernel (x86 only).
+int denseRelaxSse41(int* key, int* parent, int* row, int n, int u); // SSE4.1 kernel (x86 only).
+DenseKernel selectDenseKernel(void); // Runtime CPU dispatch between the kernels.
+
+// **Q: Compressed Adjacency**
+size_t varintSize(unsigned int value); // Bytes taken by a LEB128 value.
+unsigned char* writeVarint(unsigned char* out, unsigned int value); // Appends a LEB128 value.
+unsigned int zigzagGap(int from, int to); // Zigzag code of a signed neighbor gap.
+CompressedGraph* compressGraph(Graph* graph); // Packs a CSR graph into delta/varint edge lists.
+void freeCompressedGraph(CompressedGraph* graph); // Releases a compressed graph.
+int* build_compressed_prim_tree(CompressedGraph* Net); // Prim over the compressed lists; same result as build_prim_tree.
+void find_and_print_compressed_path(CompressedGraph* tree, PathWorkspace* ws, int first, int last); // Tree path search on compressed lists.
+
+// **R: Streaming MST**
+bool inputEdgeLess(const InputEdge* x, const InputEdge* y); // Total edge order: cost, low end, high end.
+int compareInputEdges(const void* x, const void* y); // qsort comparator for inputEdgeLess.
+int* build_streaming_tree(Reader* in, int n, size_t budget); // Kruskal over the edge stream within a memory budget.
+int mergeChunk(InputEdge* chunk, int size, InputEdge* forest, int count, InputEdge* next,
+    int* parent, int* rank, int n); // Spanning forest of a sorted chunk plus the current forest.
+
+// **S: Shortest Paths**
+DijkstraWorkspace* makeDijkstraWorkspace(int n); // Allocates a reusable Dijkstra workspace.
+void freeDijkstraWorkspace(DijkstraWorkspace* ws); // Releases a Dijkstra workspace.
+bool distanceLess(DistanceCandidate x, DistanceCandidate y); // Heap order: distance, then node id.
+void pushDistance(DistanceHeap* heap, int v, long long dist); // Inserts v or lowers its key.
+int popDistance(DistanceHeap* heap); // Removes and settles the closest node.
+void dijkstra(Graph* Net, DijkstraWorkspace* ws, const int* sources, int count, long long* dist, int* pred); // Multi-source Dijkstra.
+void dijkstraWorker(void* arg, int id); // Worker of dijkstraManySources.
+void dijkstraManySources(Graph* Net, const int* sources, int count, int threads, long long* dist, int* pred); // One run per source, in parallel.
+void printDistances(const long long* dist, int n); // Prints one line of distances, -1 where unreachable.
+void printShortestPath(int* pred, int first, int last, int* scratch); // Prints the path to `last` from predecessors.
+
+// **T: Vertex Reordering**
+int* computeOrder(Graph* Net, ReorderKind kind); // New id of every node under the chosen order.
+int compareKeys(const void* x, const void* y); // qsort comparator for 64-bit keys.
+void sortByDegree(Graph* Net, int* nodes, int count, long long* keys); // Sorts nodes by (degree, id).
+Graph* permuteGraph(Graph* Net, const int* newId); // Rebuilds the network under new ids.
+int* restoreOrder(int* prim, const int* newId, int n); // Maps a parent array back to the original ids.
+
+// **U: MST Cache**
+unsigned long long hashWords(unsigned long long hash, const int* words, size_t count); // FNV-1a over 32-bit words.
+unsigned long long cacheKey(Graph* Net, unsigned int mode); // Cache key of a network and the options.
+char* cacheFilePath(const char* dir, unsigned long long key); // Path of a cache entry.
+PathIndex* loadMstCache(const char* dir, unsigned long long key, int n, int** prim); // Maps a cached tree and index, or NULL.
+bool saveMstCache(const char* dir, unsigned long long key, int* Prim, PathIndex* index); // Stores a tree and its index.
+
+// **V: Query Service**
+void reserveOutput(OutputBuffer* out, size_t extra); // Makes room for `extra` more bytes.
+char* putLong(char* p, long long value, char end); // Formats a signed integer and a separator.
+void appendOutput(OutputBuffer* out, const char* text, size_t length); // Appends bytes to a buffer.
+void formatIndexedPath(PathIndex* index, int first, int last, OutputBuffer* out); // One answer line.
+void formatPathCost(CostIndex* costs, int first, int last, OutputBuffer* out); // One "bottleneck total" line.
+void answerQueries(void* arg, int id); // Worker: answers one slice of a batch.
+void runQueryBatch(QueryBatch* batch, FILE* out); // Answers and writes the pending queries.
+bool readQuery(Reader* in, int* first, int* last); // Next query pair, QUERY_MALFORMED for a bad token.
+long long serveQueries(PathIndex* index, CostIndex* costs, Reader* in, FILE* out, int threads); // Answers queries until the input ends.
+int serveSocket(PathIndex* index, CostIndex* costs, const char* path, int threads); // Serves queries on a Unix domain socket.
+
+// **W: Path Costs**
+int* treeEdgeCosts(Graph* Net, int* Prim, const int* newId); // Cost of every node's parent edge.
+CostIndex* buildCostIndex(PathIndex* index, int* Prim, int* parentCost); // Max/sum tables over the MST.
+bool queryPathCost(CostIndex* costs, int u, int v, int* bottleneck, long long* total); // O(log n) path aggregates.
+void printPathCost(CostIndex* costs, int first, int last); // Prints "bottleneck total" for a pair.
+void freeCostIndex(CostIndex* costs); // Frees the cost tables (not the path index).
+
+// **X: Library Interface** (public functions are declared in netlib.h)
+bool growArray(void** array, size_t bytes); // realloc that leaves the array intact on failure.
+NetStatus reserveNodes(NetContext* ctx, int n); // Grows the per-node buffers to n nodes.
+NetStatus reserveEdges(NetContext* ctx, int m); // Grows the per-edge buffers to m connections.
+
+// **Y: Export**
+void flushOutput(OutputBuffer* out, FILE* file, const char* path); // Writes and empties a buffer.
+FILE* openExport(const char* path, OutputBuffer* out); // Opens an export file and its buffer.
+void closeExport(FILE* file, OutputBuffer* out, const char* path); // Writes the rest and closes the file.
+void exportParentsText(const char* path, int* Prim, int n); // Parent array as text, one per line.
+void exportTreeEdgesText(const char* path, int* Prim, int* parentCost, int n); // MST edges in the input format.
+void exportMstBinary(const char* path, int* Prim, int* parentCost, int n); // Parents and costs as binary.
+long long exportPathsBinary(PathIndex* index, Reader* in, const char* path); // Query paths as binary records.
 
 // **Debugging Functions**
-void debug_print_graph(EdgeList* primpath, int size); // Prints the graph structure for debugging.
-void find_and_print_path_with_debug(EdgeList* primpath, int size, int first, int last); // Debugging version of pathfinding.
\ No newline at end of file
+void debug_print_graph(Graph* primpath); // Prints the graph structure for debugging.
+void find_and_print_path_with_debug(Graph* primpath, PathWorkspace* ws, int first, int last); // Debugging version of pathfinding.
\ No newline at end of file
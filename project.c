@@ -2,22 +2,389 @@
 #include <stdio.h>
 #include "pro.h"
 
-int main()
+bool parseGraphKind(const char* name, GraphKind* kind) {
+    // Maps a --bench argument to its GraphKind; returns false for unknown names.
+    const char* names[] = { "random", "grid", "powerlaw", "chain" };
+    const GraphKind kinds[] = { GRAPH_RANDOM, GRAPH_GRID, GRAPH_POWERLAW, GRAPH_CHAIN };
+
+    for (int i = 0; i < 4; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *kind = kinds[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseByteSize(const char* text, size_t* bytes) {
+    // Parses a positive byte count with an optional K, M or G suffix (powers of 1024).
+    char* end;
+    unsigned long long value = strtoull(text, &end, 10);
+
+    if (end == text || value == 0)
+        return false;
+    if (*end == 'K' || *end == 'k')
+        value <<= 10, end++;
+    else if (*end == 'M' || *end == 'm')
+        value <<= 20, end++;
+    else if (*end == 'G' || *end == 'g')
+        value <<= 30, end++;
+    if (*end != '\0')
+        return false;
+    *bytes = (size_t)value;
+    return true;
+}
+
+bool parseReorder(const char* name, ReorderKind* kind) {
+    // Maps a --reorder argument to its ReorderKind; returns false for unknown names.
+    const char* names[] = { "none", "bfs", "rcm", "degree" };
+    const ReorderKind kinds[] = { REORDER_NONE, REORDER_BFS, REORDER_RCM, REORDER_DEGREE };
+
+    for (int i = 0; i < 4; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *kind = kinds[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char* argv[])
 {
     int n, i;
-    EdgeList* Net;
+    Graph* Net;
     int* Prim;
-    EdgeList* PrimPath;
+    PathIndex* Index;
     int first, last;
-    scanf("%d", &n);
-    Net = build_net(n);
-    Prim = build_prim_tree(Net, n);
-    PrimPath = build_paths(Prim, n);
-    scanf("%d%d", &first, &last);
-    find_and_print_path(PrimPath, n, first, last);
-    freeEdgeList(Net, n);
-    free(Prim);
-    freeEdgeList(PrimPath, n);
+    const char* loadPath = NULL;
+    const char* convertPath = NULL;
+    MstEngine engine = ENGINE_PRIM;
+    bool forest = false;
+    bool compressed = false;
+    bool usage = false;
+    size_t streamBudget = 0;
+    bool shortest = false;
+    int sourceCount = 0;
+    bool distanceTable = false;
+    bool dijkstraMode;
+    bool serve = false;
+    bool pathCost = false;
+    int* parentCost = NULL;
+    CostIndex* Costs = NULL;
+    const char* parentsPath = NULL;
+    const char* edgesPath = NULL;
+    const char* mstPath = NULL;
+    const char* pathsPath = NULL;
+    bool exporting;
+    const char* socketPath = NULL;
+    const char* cacheDir = NULL;
+    int updates = 0;
+    DynamicMst* Dynamic;
+    unsigned long long key = 0;
+    CompressedGraph* Packed;
+    int threads = cpuCount();
+    bool bench = false;
+    ReorderKind reorder = REORDER_NONE;
+    int* newId;
+    BenchConfig config = { GRAPH_RANDOM, 100000, 8, 1, 1000, ENGINE_PRIM, false, false, false, REORDER_NONE, 1 };
+    Reader* in = openReader(stdin);
+
+    // Optional flags; without any the program reads everything from stdin as before.
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--convert") == 0 && i + 1 < argc)
+            convertPath = argv[++i]; // Convert a text network to the binary format and stop.
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc)
+            loadPath = argv[++i];    // Load a binary network instead of reading it from stdin.
+        else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc && parseEngine(argv[i + 1], &engine))
+            i++;
+        else if (strcmp(argv[i], "--stats") == 0)
+            atexit(dumpStats);       // Counters as JSON on stderr, also after an error exit.
+        else if (strcmp(argv[i], "--forest") == 0)
+            forest = true;           // Spanning forest instead of failing on a disconnected network.
+        else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc && parseByteSize(argv[i + 1], &streamBudget))
+            i++;                     // Kruskal over the edge stream within this many bytes.
+        else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+            cacheDir = argv[++i];    // Reuse (or store) the tree and index of this network.
+        else if (strcmp(argv[i], "--serve") == 0)
+            serve = true;            // Answer a stream of queries from stdin until it ends.
+        else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc)
+            socketPath = argv[++i];  // Answer queries from clients of this Unix domain socket.
+        else if (strcmp(argv[i], "--path-cost") == 0)
+            pathCost = true;         // Bottleneck and total cost of the MST path instead of the path.
+        else if (strcmp(argv[i], "--export-parents") == 0 && i + 1 < argc)
+            parentsPath = argv[++i]; // Write the Prim array as text.
+        else if (strcmp(argv[i], "--export-edges") == 0 && i + 1 < argc)
+            edgesPath = argv[++i];   // Write the MST edges as a text network.
+        else if (strcmp(argv[i], "--export-mst") == 0 && i + 1 < argc)
+            mstPath = argv[++i];     // Write the Prim array and edge costs as binary.
+        else if (strcmp(argv[i], "--export-paths") == 0 && i + 1 < argc)
+            pathsPath = argv[++i];   // Answer every query from stdin into a binary file.
+        else if (strcmp(argv[i], "--updates") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            updates = atoi(argv[++i]); // Read this many new or cheaper links after the network.
+        else if (strcmp(argv[i], "--shortest") == 0)
+            shortest = true;         // Cheapest path over the whole network instead of the MST path.
+        else if ((strcmp(argv[i], "--distances") == 0 || strcmp(argv[i], "--distance-table") == 0) &&
+            i + 1 < argc && atoi(argv[i + 1]) > 0 && sourceCount == 0) {
+            distanceTable = strcmp(argv[i], "--distance-table") == 0; // One row per source.
+            sourceCount = atoi(argv[++i]); // Distances from this many sources read after the network.
+        }
+        else if (strcmp(argv[i], "--reorder") == 0 && i + 1 < argc && parseReorder(argv[i + 1], &reorder))
+            i++;                     // Relabel the nodes for locality before the MST.
+        else if (strcmp(argv[i], "--shuffle") == 0)
+            config.shuffle = true;
+        else if (strcmp(argv[i], "--compressed") == 0)
+            compressed = true;       // Prim on delta/varint-packed edge lists.
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc && parseGraphKind(argv[i + 1], &config.kind)) {
+            bench = true;            // Benchmark on a generated graph instead of reading input.
+            i++;
+        }
+        else if (strcmp(argv[i], "--nodes") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            config.nodes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--degree") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            config.degree = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            config.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 0)
+            config.queries = atoi(argv[++i]);
+        else {
+            usage = true;
+            break;
+        }
+    }
+
+    dijkstraMode = shortest || sourceCount > 0; // Dijkstra over the network; no MST is built.
+    // The compressed lists are only iterated by Prim; the stream never builds a network.
+    exporting = parentsPath != NULL || edgesPath != NULL || mstPath != NULL || pathsPath != NULL;
+    if (usage || (compressed && (forest || engine != ENGINE_PRIM)) || (forest && engine != ENGINE_PRIM) ||
+        (streamBudget > 0 && (compressed || forest || engine != ENGINE_PRIM || loadPath != NULL || convertPath != NULL)) ||
+        (dijkstraMode && ((shortest && sourceCount > 0) || streamBudget > 0 || compressed || forest || engine != ENGINE_PRIM)) ||
+        (reorder != REORDER_NONE && (streamBudget > 0 || dijkstraMode || convertPath != NULL)) ||
+        (cacheDir != NULL && (streamBudget > 0 || dijkstraMode || convertPath != NULL)) ||
+        ((serve || socketPath != NULL) && (dijkstraMode || convertPath != NULL || (serve && socketPath != NULL))) ||
+        (pathCost && (streamBudget > 0 || compressed || dijkstraMode || convertPath != NULL)) ||
+        (exporting && (dijkstraMode || convertPath != NULL)) ||
+        ((edgesPath != NULL || mstPath != NULL) && (streamBudget > 0 || compressed)) ||
+        (pathsPath != NULL && (serve || socketPath != NULL || pathCost)) ||
+        (updates > 0 && (streamBudget > 0 || compressed || dijkstraMode || reorder != REORDER_NONE || cacheDir != NULL || convertPath != NULL))) {
+        printf("usage: %s [--convert file | --load file] [--engine prim|boruvka|kruskal|auto|dense | --forest | --compressed]\n"
+            "          [--reorder none|bfs|rcm|degree | --updates k] [--cache dir] [--path-cost]\n"
+            "          [--serve | --socket path | --export-paths file] [--export-parents file]\n"
+            "          [--export-edges file] [--export-mst file] [--threads n] [--stats]\n"
+            "       %s --stream bytes[K|M|G] [--stats]\n"
+            "       %s --shortest | --distances k | --distance-table k [--load file] [--threads n] [--stats]\n"
+            "       %s --bench random|grid|powerlaw|chain [--nodes n] [--degree d] [--seed s] [--queries q] [--shuffle] [engine options]\n",
+            argv[0], argv[0], argv[0], argv[0]);
+        return 1;
+    }
+
+    if (bench) {
+        config.engine = engine;
+        config.forest = forest;
+        config.compressed = compressed;
+        config.reorder = reorder;
+        config.threads = threads;
+        closeReader(in);
+        return runBenchmark(&config);
+    }
+
+    if (convertPath != NULL) {
+        if (!readInt(in, &n))
+            n = -1; // Missing input is rejected by build_net.
+        Net = build_net(in, n);
+        saveGraph(Net, convertPath);
+        freeGraph(Net);
+        closeReader(in);
+        return 0;
+    }
+
+    STAT_PHASE_START(readStart);
+    if (streamBudget > 0) {
+        if (!readInt(in, &n))
+            n = -1; // Missing input is rejected by build_streaming_tree.
+        Net = NULL; // The edges are never held as a network.
+    }
+    else if (loadPath != NULL) {
+        Net = loadGraph(loadPath);
+        n = Net->n;
+    }
+    else {
+        if (!readInt(in, &n))
+            n = -1; // Missing input is rejected by build_net.
+        Net = build_net(in, n);
+    }
+    STAT_PHASE_END("read_network", readStart);
+
+    if (shortest) {
+        // Dijkstra from `first` over the network; the MST is not needed.
+        if (!readInt(in, &first) || !readInt(in, &last) || first < 0 || first >= n || last < 0 || last >= n) {
+            printf("invalid input");
+            exit(1);
+        }
+        STAT_PHASE_START(shortestStart);
+        DijkstraWorkspace* ws = makeDijkstraWorkspace(n);
+        long long* dist = (long long*)allocOrExit(sizeof(long long) * n);
+        int* pred = (int*)allocOrExit(sizeof(int) * n);
+        int* scratch = (int*)allocOrExit(sizeof(int) * n);
+        dijkstra(Net, ws, &first, 1, dist, pred);
+        printShortestPath(pred, first, last, scratch);
+        STAT_PHASE_END("shortest_path", shortestStart);
+        free(dist);
+        free(pred);
+        free(scratch);
+        freeDijkstraWorkspace(ws);
+        freeGraph(Net);
+        closeReader(in);
+        return 0;
+    }
+
+    if (sourceCount > 0) {
+        // Distances from `sourceCount` source ids read after the network: to the nearest of
+        // them in one run, or one row per source, spread over the worker threads.
+        STAT_PHASE_START(distanceStart);
+        int* sources = (int*)allocOrExit(sizeof(int) * sourceCount);
+        size_t rows = distanceTable ? (size_t)sourceCount : 1;
+        long long* dist = (long long*)allocOrExit(sizeof(long long) * (size_t)n * rows);
+        int* pred = (int*)allocOrExit(sizeof(int) * (size_t)n * rows);
+        for (i = 0; i < sourceCount; i++) {
+            if (!readInt(in, &sources[i]) || sources[i] < 0 || sources[i] >= n) {
+                printf("invalid input");
+                exit(1);
+            }
+        }
+        if (distanceTable)
+            dijkstraManySources(Net, sources, sourceCount, threads, dist, pred);
+        else {
+            DijkstraWorkspace* ws = makeDijkstraWorkspace(n);
+            dijkstra(Net, ws, sources, sourceCount, dist, pred);
+            freeDijkstraWorkspace(ws);
+        }
+        for (i = 0; (size_t)i < rows; i++)
+            printDistances(dist + (size_t)i * n, n);
+        STAT_PHASE_END("distances", distanceStart);
+        free(sources);
+        free(dist);
+        free(pred);
+        freeGraph(Net);
+        closeReader(in);
+        return 0;
+    }
+
+    // A cached tree and index for this network skip the MST and the index build.
+    Index = NULL;
+    if (cacheDir != NULL) {
+        STAT_PHASE_START(cacheStart);
+        key = cacheKey(Net, (unsigned int)engine | (forest ? 0x10u : 0) | ((unsigned int)reorder << 5));
+        Index = loadMstCache(cacheDir, key, n, &Prim);
+        STAT_PHASE_END("cache_lookup", cacheStart);
+    }
+    if (Index == NULL) {
+        if (reorder != REORDER_NONE) {
+            // The MST runs on the relabeled network; its parent array is mapped back below.
+            STAT_PHASE_START(reorderStart);
+            Graph* Reordered;
+            newId = computeOrder(Net, reorder);
+            Reordered = permuteGraph(Net, newId);
+            freeGraph(Net);
+            Net = Reordered;
+            STAT_PHASE_END("reorder", reorderStart);
+        }
+        STAT_PHASE_START(mstStart);
+        if (streamBudget > 0)
+            Prim = build_streaming_tree(in, n, streamBudget);
+        else if (compressed) {
+            // The CSR graph is released as soon as it is packed.
+            Packed = compressGraph(Net);
+            freeGraph(Net);
+            Net = NULL;
+            Prim = build_compressed_prim_tree(Packed);
+            freeCompressedGraph(Packed);
+        }
+        else
+            Prim = forest ? build_prim_forest(Net, threads) : build_mst(Net, engine, threads);
+        if (reorder != REORDER_NONE) {
+            Prim = restoreOrder(Prim, newId, n);
+            if (pathCost || edgesPath != NULL || mstPath != NULL)
+                parentCost = treeEdgeCosts(Net, Prim, newId); // Net still uses the new ids.
+            free(newId);
+        }
+        STAT_PHASE_END("build_mst", mstStart);
+        if (updates > 0) {
+            // Each "a b cost" link patches the tree in place; the index is built from the result.
+            STAT_PHASE_START(updateStart);
+            Dynamic = makeDynamicMst(Net, Prim);
+            for (i = 0; i < updates; i++) {
+                int a, b, cost;
+                if (!readInt(in, &a) || !readInt(in, &b) || !readInt(in, &cost)) {
+                    printf("invalid input");
+                    exit(1);
+                }
+                updateMst(Dynamic, a, b, cost);
+            }
+            // New links are not in Net, so the tree edge costs come from the maintained tree.
+            if (pathCost || edgesPath != NULL || mstPath != NULL) {
+                parentCost = (int*)allocOrExit(sizeof(int) * n);
+                memcpy(parentCost, Dynamic->cost, sizeof(int) * n);
+            }
+            freeDynamicMst(Dynamic);
+            STAT_PHASE_END("update_mst", updateStart);
+        }
+        // Every query goes through the index, so the CSR tree (build_paths) is not needed here.
+        STAT_PHASE_START(indexStart);
+        Index = buildPathIndex(Prim, n); // Answers path queries without a DFS per query.
+        STAT_PHASE_END("build_path_index", indexStart);
+        if (cacheDir != NULL)
+            saveMstCache(cacheDir, key, Prim, Index);
+    }
+    if (parentCost == NULL && (pathCost || edgesPath != NULL || mstPath != NULL))
+        parentCost = treeEdgeCosts(Net, Prim, NULL);
+    if (pathCost) {
+        STAT_PHASE_START(costStart);
+        Costs = buildCostIndex(Index, Prim, parentCost);
+        STAT_PHASE_END("build_cost_index", costStart);
+    }
+    if (parentsPath != NULL || edgesPath != NULL || mstPath != NULL) {
+        STAT_PHASE_START(exportStart);
+        if (parentsPath != NULL)
+            exportParentsText(parentsPath, Prim, n);
+        if (edgesPath != NULL)
+            exportTreeEdgesText(edgesPath, Prim, parentCost, n);
+        if (mstPath != NULL)
+            exportMstBinary(mstPath, Prim, parentCost, n);
+        STAT_PHASE_END("export", exportStart);
+    }
+    STAT_PHASE_START(queryStart);
+    if (pathsPath != NULL)
+        exportPathsBinary(Index, in, pathsPath);
+    else if (serve)
+        serveQueries(Index, Costs, in, stdout, threads);
+    else if (socketPath != NULL) {
+        if (serveSocket(Index, Costs, socketPath, threads) != 0)
+            exit(1);
+    }
+    else {
+        if (!readInt(in, &first) || !readInt(in, &last)) {
+            if (!exporting) {
+                printf("invalid input");
+                exit(1);
+            }
+        }
+        else if (Costs != NULL)
+            printPathCost(Costs, first, last);
+        else
+            printIndexedPath(Index, first, last);
+    }
+    STAT_PHASE_END("path_query", queryStart);
+    if (Net != NULL)
+        freeGraph(Net);
+    if (Index->mapping == NULL)
+        free(Prim); // Otherwise it points into the cache file mapping.
+    if (Costs != NULL)
+        freeCostIndex(Costs);
+    free(parentCost);
+    freePathIndex(Index);
+    closeReader(in);
 
     return 0;
-}
\ No newline at end of file
+}
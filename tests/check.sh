@@ -0,0 +1,455 @@
+#!/bin/sh
+# Differential checks of the MST engines and services against each other.
+# usage: tests/check.sh [compiler]   (run from anywhere; prints "ALL OK" on success)
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+cc=${1:-${CC:-cc}}
+failed=0
+
+"$cc" -std=c11 -O2 -pthread -o "$work/project" "$root"/*.c || exit 1
+project="$work/project"
+
+fail() {
+    echo "FAIL: $1"
+    failed=1
+}
+
+# network nodes edges seed [maxcost] [parts]: a random network without repeated links,
+# made of `parts` connected components (1 by default) over consecutive node ranges.
+network() {
+    awk -v n="$1" -v m="$2" -v seed="$3" -v maxcost="${4:-1000}" -v parts="${5:-1}" 'BEGIN {
+        srand(seed)
+        size = int((n + parts - 1) / parts)
+        for (v = 1; v < n; v++) {
+            start = v - v % size
+            if (v == start) continue
+            u = start + int(rand() * (v - start))
+            seen[u " " v] = 1
+            line[count++] = u " " v " " int(rand() * maxcost)
+        }
+        while (count < m) {
+            a = int(rand() * n)
+            start = a - a % size
+            b = start + int(rand() * size)
+            if (b >= n || a == b) continue
+            if (a > b) { t = a; a = b; b = t }
+            if ((a " " b) in seen) continue
+            seen[a " " b] = 1
+            line[count++] = a " " b " " int(rand() * maxcost)
+        }
+        print n; print count
+        for (i = 0; i < count; i++) print line[i]
+    }'
+}
+
+# Total cost of an --export-edges file (its edge lines follow the two counts).
+tree_cost() {
+    awk 'NR > 2 { total += $3 } END { print total + 0 }' "$1"
+}
+
+# Minimum spanning forest cost of a network file, with Kruskal in awk over sort(1), so it
+# does not share any code with the program.
+reference_cost() {
+    tail -n +3 "$1" | sort -n -k3,3 | awk -v n="$(head -n 1 "$1")" '
+        function find(x) { while (parent[x] != x) x = parent[x] = parent[parent[x]]; return x }
+        BEGIN { for (v = 0; v < n; v++) parent[v] = v }
+        { a = find($1); b = find($2); if (a != b) { parent[a] = b; total += $3 } }
+        END { print total + 0 }'
+}
+
+# use_network nodes edges seed [maxcost] [parts]: makes the network the next checks run on.
+use_network() {
+    nodes=$1 parts=${5:-1}
+    label="$1/$2/$3"
+    network "$@" > "$work/net.txt"
+    want=$(reference_cost "$work/net.txt")
+}
+
+# each_network check: runs `check` on sparse, tied, near-complete and wide-cost networks.
+each_network() {
+    for spec in 300:900:1:1000 500:5000:2:4 60:1700:3:50 3000:6000:4:100000; do
+        use_network $(echo "$spec" | tr : ' ')
+        "$1"
+    done
+}
+
+# check_tree options...: the tree (or forest) built with these options must cost as much
+# as the reference and hold one edge per node that is not a root.
+check_tree() {
+    "$project" "$@" --export-edges "$work/edges.txt" < "$work/net.txt" > /dev/null ||
+        { fail "$label: $* failed"; return; }
+    [ "$(tree_cost "$work/edges.txt")" = "$want" ] ||
+        fail "$label: $* costs $(tree_cost "$work/edges.txt"), reference $want"
+    [ "$(sed -n 2p "$work/edges.txt")" = "$((nodes - parts))" ] ||
+        fail "$label: $* kept $(sed -n 2p "$work/edges.txt") edges"
+}
+
+# same_parents "reference options" "options"...: each run must give the reference's parent array.
+same_parents() {
+    reference=$1
+    shift
+    "$project" $reference --export-parents "$work/first.txt" < "$work/net.txt" > /dev/null ||
+        { fail "$label: $reference failed"; return; }
+    for options in "$@"; do
+        "$project" $options --export-parents "$work/parents.txt" < "$work/net.txt" > /dev/null ||
+            { fail "$label: $options failed"; continue; }
+        cmp -s "$work/first.txt" "$work/parents.txt" || fail "$label: $options parents differ from $reference"
+    done
+}
+
+# The heap Prim of the default engine.
+check_prim() {
+    check_tree --engine prim
+}
+
+# patch file offset bytes...: overwrites the file at `offset` with the given octal bytes.
+patch() {
+    file=$1 offset=$2
+    shift 2
+    printf "$(printf '\\%s' "$@")" | dd of="$file" bs=1 seek="$offset" conv=notrunc 2> /dev/null
+}
+
+# copy file from to: overwrites the 32-bit word at offset `to` with the one at `from`.
+copy() {
+    dd if="$1" bs=1 skip="$2" count=4 2> /dev/null | dd of="$1" bs=1 seek="$3" conv=notrunc 2> /dev/null
+}
+
+# A triangle converted to a binary file must load, and each damaged copy must be rejected.
+# Its rows are 0: (1, 1) (2, 3), 1: (0, 1) (2, 2) and 2: (0, 3) (1, 2), so the neighbors
+# start at byte 48 and the costs at byte 72, after the header and the four offsets.
+check_graph_files() {
+    printf '3\n3\n0 1 1\n1 2 2\n0 2 3\n' | "$project" --convert "$work/good.bin" > /dev/null ||
+        { fail "graph files: --convert failed"; return; }
+    echo "0 2" | "$project" --load "$work/good.bin" | grep -q "invalid graph file" &&
+        fail "graph files: a valid file was rejected"
+    for damage in flags unsorted negative mirror; do
+        cp "$work/good.bin" "$work/bad.bin"
+        case $damage in
+            flags) patch "$work/bad.bin" 8 000 000 000 000 ;;
+            unsorted) copy "$work/bad.bin" 52 48; copy "$work/bad.bin" 64 52 ;;
+            negative) patch "$work/bad.bin" 76 377 377 377 377 ;;
+            mirror) copy "$work/bad.bin" 76 72 ;;
+        esac
+        echo "0 2" | "$project" --load "$work/bad.bin" > "$work/out.txt" &&
+            fail "graph files: a file with bad $damage loaded"
+        grep -q "invalid graph file" "$work/out.txt" || fail "graph files: bad $damage was not reported"
+    done
+}
+
+# A --serve line holding a token that is not a number is answered "Invalid input." and the
+# server goes on with the next line.
+check_bad_tokens() {
+    printf '4\n3\n0 1 1\n1 2 1\n2 3 1\n' | "$project" --convert "$work/chain.bin" > /dev/null ||
+        { fail "bad tokens: --convert failed"; return; }
+    printf '0 3\nabc 2\n1 x\n5 1\n3 2\n12ab 1\n2 -\n1 0' | "$project" --load "$work/chain.bin" --serve > "$work/out.txt"
+    printf '0 1 2 3 \nInvalid input.\nInvalid input.\ninvalid input\n3 2 \nInvalid input.\nInvalid input.\n1 0 \n' |
+        cmp -s - "$work/out.txt" || fail "bad tokens: --serve did not skip the bad lines"
+}
+
+# queries nodes count seed: random start/end pairs, plus a repeated node and two bad ids.
+queries() {
+    awk -v n="$1" -v q="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        for (i = 0; i < q; i++) print int(rand() * n), int(rand() * n)
+        print 0, 0; print -1, 0; print 0, n
+    }'
+}
+
+# Runs the program on the binary copy of the network, which keeps the input prompt out of
+# the answers.
+run() {
+    "$project" --load "$work/net.bin" $forest "$@"
+}
+
+# use_queries nodes edges seed parts: a network (a forest when parts > 1), 300 queries and
+# their --serve answers, with the tree exported next to them.
+use_queries() {
+    use_network "$1" "$2" "$3" 1000 "$4"
+    forest=""
+    [ "$parts" = 1 ] || forest="--forest"
+    queries "$nodes" 300 "$3" > "$work/queries.txt"
+    "$project" --convert "$work/net.bin" < "$work/net.txt" > /dev/null || fail "$label: --convert failed"
+    run --serve --threads 1 --export-edges "$work/edges.txt" < "$work/queries.txt" > "$work/serve.txt" ||
+        fail "$label: --serve failed"
+}
+
+# each_query_network check: runs `check` after use_queries on every query network.
+each_query_network() {
+    for spec in $QUERY_NETWORKS; do
+        use_queries $(echo "$spec" | tr : ' ')
+        "$1"
+    done
+}
+
+# Every indexed answer must run from its start to its end along tree edges, and only
+# nodes in different components may be answered NO PATH.
+check_paths() {
+    paste -d '|' "$work/queries.txt" "$work/serve.txt" | awk -F '|' -v n="$nodes" -v size=$(((nodes + parts - 1) / parts)) '
+        FNR == NR { if (FNR > 2) { split($0, e, " "); edge[e[1] " " e[2]] = edge[e[2] " " e[1]] = 1 } next }
+        { split($1, q, " "); count = split($2, p, " ")
+          if (q[1] < 0 || q[1] >= n || q[2] < 0 || q[2] >= n) { if ($2 != "invalid input") bad++; next }
+          if ($2 == "NO PATH") { if (int(q[1] / size) == int(q[2] / size)) bad++; next }
+          if (p[1] != q[1] || p[count] != q[2]) { bad++; next }
+          for (i = 1; i < count; i++)
+              if (!((p[i] " " p[i + 1]) in edge)) { bad++; next } }
+        END { exit bad > 0 }' "$work/edges.txt" - || fail "$label: a path does not follow the tree"
+}
+
+# Borůvka on one and several threads; its (cost, low, high) tie order gives Kruskal's tree.
+check_boruvka() {
+    check_tree --engine boruvka --threads 1
+    check_tree --engine boruvka --threads 4
+    same_parents "--engine kruskal" "--engine boruvka --threads 1" "--engine boruvka --threads 3"
+}
+
+# Kruskal, and the engine `auto` picks from the density.
+check_kruskal() {
+    check_tree --engine kruskal
+    check_tree --engine auto
+}
+
+# The spanning forest, built per component.
+check_forest() {
+    check_tree --forest
+    check_tree --forest --threads 1
+}
+
+# Incremental updates must give a tree as cheap as Kruskal on the updated network.
+check_updates() {
+    nodes=$1 edges=$2 updates=$3 seed=$4
+    network "$nodes" "$edges" "$seed" > "$work/net.txt"
+    # Half of the links are cheaper copies of existing ones, half are new pairs.
+    awk -v k="$updates" -v seed="$seed" 'NR == 1 { n = $1 } NR > 2 { line[count++] = $0 }
+        END {
+            srand(seed + 1)
+            for (i = 0; i < k; i++) {
+                if (i % 2 == 0) {
+                    split(line[int(rand() * count)], e, " ")
+                    print e[1], e[2], int(e[3] * rand())
+                }
+                else {
+                    do { a = int(rand() * n); b = int(rand() * n) } while (a == b)
+                    print a, b, int(rand() * 1000)
+                }
+            }
+        }' "$work/net.txt" > "$work/updates.txt"
+    # The updated network keeps the cheapest cost of every pair.
+    awk 'NR == FNR && FNR <= 2 { if (FNR == 1) n = $1; next }
+        { a = $1; b = $2; if (a > b) { t = a; a = b; b = t }
+          key = a " " b
+          if (!(key in cost) || $3 < cost[key]) cost[key] = $3 }
+        END { count = 0; for (key in cost) count++
+              print n; print count
+              for (key in cost) print key, cost[key] }' "$work/net.txt" "$work/updates.txt" > "$work/updated.txt"
+
+    cat "$work/net.txt" "$work/updates.txt" | "$project" --updates "$updates" --export-edges "$work/patched.txt" > /dev/null ||
+        { fail "updates $*: project failed"; return; }
+    "$project" --engine kruskal --export-edges "$work/rebuilt.txt" < "$work/updated.txt" > /dev/null ||
+        { fail "updates $*: kruskal failed"; return; }
+    [ "$(tree_cost "$work/patched.txt")" = "$(tree_cost "$work/rebuilt.txt")" ] ||
+        fail "updates $*: patched tree costs $(tree_cost "$work/patched.txt"), rebuilt $(tree_cost "$work/rebuilt.txt")"
+}
+
+# Dense Prim builds the same parent array as the heap version.
+check_dense() {
+    check_tree --engine dense
+    same_parents "--engine prim" "--engine dense"
+}
+
+# Prim on the compressed lists builds the same parent array as on the CSR graph.
+check_compressed() {
+    same_parents "--engine prim" --compressed
+}
+
+# The stream, in many small chunks and in one, builds Kruskal's tree.
+check_stream() {
+    same_parents "--engine kruskal" "--stream 1K" "--stream 1G"
+}
+
+# With repeated connections the stream keeps the cheapest copy of each (build_net keeps the
+# first), so it must give Kruskal's tree of the network reduced to the cheapest copies.
+check_stream_repeats() {
+    network 400 1200 "$1" 1000 > "$work/net.txt"
+    awk -v seed="$1" 'NR == 1 { n = $1 } NR > 2 { line[count++] = $0 }
+        END { srand(seed)
+              print n; print count + 300
+              for (i = 0; i < count; i++) print line[i]
+              for (i = 0; i < 300; i++) {
+                  split(line[int(rand() * count)], e, " ")
+                  print e[2], e[1], int(rand() * 1000) } }' "$work/net.txt" > "$work/repeats.txt"
+    awk 'NR == 1 { n = $1 } NR > 2 { a = $1 < $2 ? $1 : $2; b = $1 < $2 ? $2 : $1; key = a " " b
+                                   if (!(key in cost) || $3 < cost[key]) cost[key] = $3 }
+        END { count = 0; for (key in cost) count++
+              print n; print count
+              for (key in cost) print key, cost[key] }' "$work/repeats.txt" > "$work/cheapest.txt"
+    "$project" --engine kruskal --export-parents "$work/first.txt" < "$work/cheapest.txt" > /dev/null
+    "$project" --stream 1K --export-parents "$work/parents.txt" < "$work/repeats.txt" > /dev/null ||
+        { fail "stream repeats $1: --stream failed"; return; }
+    cmp -s "$work/first.txt" "$work/parents.txt" || fail "stream repeats $1: parents differ from the cheapest copies' tree"
+}
+
+# Multi-source and per-source Dijkstra must agree with single-source runs: each table row
+# is the run from its source, the multi-source line is their minimum, and the --shortest
+# path from a source must cost its distance.
+check_distances() {
+    "$project" --convert "$work/net.bin" < "$work/net.txt" > /dev/null || { fail "$label: --convert failed"; return; }
+    awk -v n="$nodes" -v seed="$nodes" 'BEGIN { srand(seed); for (i = 0; i < 5; i++) print int(rand() * n) }' > "$work/sources.txt"
+    : > "$work/rows.txt"
+    while read -r source; do
+        echo "$source" | "$project" --load "$work/net.bin" --distances 1 >> "$work/rows.txt" ||
+            fail "$label: --distances 1 from $source failed"
+    done < "$work/sources.txt"
+    "$project" --load "$work/net.bin" --distance-table 5 --threads 3 < "$work/sources.txt" > "$work/table.txt"
+    cmp -s "$work/rows.txt" "$work/table.txt" || fail "$label: --distance-table rows differ from single-source runs"
+    "$project" --load "$work/net.bin" --distances 5 < "$work/sources.txt" > "$work/nearest.txt"
+    awk '{ for (v = 1; v <= NF; v++) if ($v != -1 && (!(v in best) || $v < best[v])) best[v] = $v
+           count = NF }
+         END { for (v = 1; v <= count; v++) printf "%s%s", (v in best ? best[v] : -1), (v < count ? " " : "\n") }' \
+        "$work/rows.txt" | cmp -s - "$work/nearest.txt" || fail "$label: --distances 5 is not the nearest source's distance"
+
+    source=$(head -n 1 "$work/sources.txt")
+    for target in 0 $((nodes / 2)) $((nodes - 1)); do
+        echo "$source $target" | "$project" --load "$work/net.bin" --shortest > "$work/path.txt"
+        echo >> "$work/path.txt"
+        awk -v source="$source" -v target="$target" '
+            FILENAME == ARGV[1] { if (FNR > 2) cost[$1 " " $2] = cost[$2 " " $1] = $3; next }
+            FILENAME == ARGV[2] { if (FNR == 1) want = $(target + 1); next }
+            $0 ~ /NO PATH/ { exit want != -1 }
+            { total = 0
+              for (i = 1; i < NF; i++) {
+                  if (!(($i " " $(i + 1)) in cost)) exit 1
+                  total += cost[$i " " $(i + 1)] }
+              exit $1 != source || $NF != target || total != want }' \
+            "$work/net.txt" "$work/rows.txt" "$work/path.txt" || fail "$label: --shortest $source $target does not cost its distance"
+    done
+}
+
+# Every vertex order may pick another tree among equally cheap ones, never a dearer one.
+check_reorder() {
+    for kind in bfs rcm degree; do
+        check_tree --reorder $kind
+    done
+}
+
+# A run that stores a cache entry and a run that maps it must answer like a fresh build.
+check_cache() {
+    rm -rf "$work/cache"
+    mkdir "$work/cache"
+    run --cache "$work/cache" --serve < "$work/queries.txt" > "$work/cached.txt"
+    cmp -s "$work/serve.txt" "$work/cached.txt" || fail "$label: answers while storing the cache differ"
+    run --cache "$work/cache" --serve < "$work/queries.txt" > "$work/cached.txt"
+    cmp -s "$work/serve.txt" "$work/cached.txt" || fail "$label: answers from the cache differ"
+}
+
+# --serve with several workers, and one query per process, must answer like --serve on one.
+check_serve() {
+    run --serve --threads 4 < "$work/queries.txt" > "$work/serve4.txt"
+    cmp -s "$work/serve.txt" "$work/serve4.txt" || fail "$label: --serve --threads 4 answers differ"
+    head -n 20 "$work/queries.txt" | while read -r a b; do
+        echo "$a $b" | run
+        echo
+    done | sed '/^$/d' > "$work/single.txt"
+    head -n 20 "$work/serve.txt" | cmp -s - "$work/single.txt" || fail "$label: single queries differ from --serve"
+}
+
+# Every --path-cost answer must be the largest and the summed edge cost of the served path.
+check_path_costs() {
+    run --serve --path-cost < "$work/queries.txt" > "$work/costs.txt"
+    paste -d '|' "$work/serve.txt" "$work/costs.txt" | awk -F '|' '
+        FNR == NR { if (FNR > 2) { split($0, e, " "); cost[e[1] " " e[2]] = cost[e[2] " " e[1]] = e[3] } next }
+        $1 == "invalid input" || $1 == "NO PATH" { if ($2 != $1) bad++; next }
+        { count = split($1, p, " "); max = 0; total = 0
+          for (i = 1; i < count; i++) {
+              c = cost[p[i] " " p[i + 1]]
+              if (c > max) max = c
+              total += c }
+          if ($2 != max " " total) bad++ }
+        END { exit bad > 0 }' "$work/edges.txt" - || fail "$label: a path cost does not match its path"
+}
+
+# The library recipes of the README must link a program that only includes netlib.h.
+check_library() {
+    mkdir "$work/lib" && cd "$work/lib" || return
+    sources=$(ls "$root"/*.c | grep -v project.c)
+    "$cc" -std=c11 -O2 -pthread -c $sources && ar rcs libnet.a *.o &&
+        "$cc" -std=c11 -O2 -pthread -I"$root" -o static "$root/tests/netlib_check.c" libnet.a &&
+        ./static > /dev/null || fail "library: static build or check failed"
+    "$cc" -std=c11 -O2 -pthread -fPIC -fvisibility=hidden -shared $sources -o libnet.so &&
+        "$cc" -std=c11 -O2 -pthread -I"$root" -o shared "$root/tests/netlib_check.c" -L. -lnet -Wl,-rpath,"$work/lib" &&
+        ./shared > /dev/null || fail "library: shared build or check failed"
+    if command -v nm > /dev/null; then
+        nm -D --defined-only libnet.so | awk '$3 !~ /^net/ { print; bad = 1 } END { exit bad }' ||
+            fail "library: libnet.so exports more than the net* functions"
+    fi
+    [ "$(printf '1\n0\n0 0\n' | "$project" | sed 's/.*://')" = "0 " ] ||
+        fail "library: the program does not answer a lone node with itself, as netFindPath does"
+    cd "$root" || exit 1
+}
+
+# Integers of a binary file, one per line, in native byte order.
+words() {
+    od -An -v -t d4 "$1" | tr -s ' ' '\n' | sed '/^$/d'
+}
+
+# The binary --export-paths records, decoded to text, must be the --serve answers.
+check_export_paths() {
+    run --export-paths "$work/paths.bin" < "$work/queries.txt" > /dev/null || fail "$label: --export-paths failed"
+    words "$work/paths.bin" | awk 'NR <= 4 { next }
+        left == 0 { left = $1; line = ""
+                    if (left == 0) print "NO PATH"; else if (left == -1) { print "invalid input"; left = 0 }
+                    next }
+        { line = line $1 " "; if (--left == 0) print line }' > "$work/exported.txt"
+    cmp -s "$work/serve.txt" "$work/exported.txt" || fail "$label: --export-paths differs from --serve"
+}
+
+# The --export-edges tree is its own MST, so loading it must give the same parents and
+# edges again, and --export-mst must hold the same parents and costs.
+check_exports() {
+    "$project" --export-parents "$work/parents.txt" --export-edges "$work/edges.txt" \
+        --export-mst "$work/mst.bin" < "$work/net.txt" > /dev/null || { fail "$label: exports failed"; return; }
+    "$project" --export-parents "$work/parents2.txt" --export-edges "$work/edges2.txt" < "$work/edges.txt" > /dev/null
+    cmp -s "$work/parents.txt" "$work/parents2.txt" && cmp -s "$work/edges.txt" "$work/edges2.txt" ||
+        fail "$label: the exported tree does not read back as itself"
+
+    words "$work/mst.bin" | awk -v n="$nodes" 'NR == 3 && $1 != n { print "bad" } NR > 4 && NR <= 4 + n' > "$work/mst_parents.txt"
+    tail -n +2 "$work/parents.txt" | cmp -s - "$work/mst_parents.txt" || fail "$label: --export-mst parents differ"
+    [ "$(words "$work/mst.bin" | awk -v n="$nodes" 'NR > 4 + n { total += $1 } END { print total + 0 }')" = \
+        "$(tree_cost "$work/edges.txt")" ] || fail "$label: --export-mst costs differ"
+}
+
+QUERY_NETWORKS="500:1500:6:1 3000:4000:7:3"
+each_network check_prim
+check_graph_files
+check_bad_tokens
+each_query_network check_paths
+each_network check_boruvka
+each_network check_kruskal
+each_network check_forest
+use_network 2000 6000 5 20 4
+check_forest
+check_updates 10 20 5 1
+check_updates 200 600 100 2
+check_updates 2000 8000 3000 3
+each_network check_dense
+each_network check_compressed
+each_network check_stream
+check_stream_repeats 11
+check_stream_repeats 12
+each_network check_distances
+use_network 2000 6000 5 20 4
+check_distances
+each_network check_reorder
+use_network 2000 6000 5 20 4
+check_tree --forest --reorder rcm
+each_query_network check_cache
+each_query_network check_serve
+each_query_network check_path_costs
+check_library
+each_query_network check_export_paths
+use_network 2000 8000 8
+check_exports
+
+[ $failed = 0 ] && echo "ALL OK"
+exit $failed
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include "netlib.h"
+
+// Consumer of the library interface, linked only against libnet (see tests/check.sh).
+// Prints "ALL OK" and returns 0 when every call reports what it should.
+
+static int failures = 0;
+
+static void expect(const char* what, NetStatus got, NetStatus want) {
+    // Reports a call whose status differs from the expected one.
+    if (got != want) {
+        printf("FAIL: %s: %s, expected %s\n", what, netStatusText(got), netStatusText(want));
+        failures++;
+    }
+}
+
+int main(void) {
+    // A small square with one diagonal, then an empty network and a disconnected one,
+    // all through the same context so the buffers are reused between loads.
+    const int square[] = { 0, 1, 4, 1, 2, 1, 2, 3, 2, 3, 0, 3, 0, 2, 5, 0, 1, 9 };
+    const int split[] = { 0, 1, 1, 2, 3, 1 };
+    const int loop[] = { 1, 1, 0 };
+    const int* parents;
+    int path[4], length = 0;
+    long long total = 0;
+    NetContext* ctx = netCreate();
+
+    if (ctx == NULL) {
+        printf("FAIL: netCreate\n");
+        return 1;
+    }
+
+    expect("build before load", netBuildMst(ctx), NET_ERROR_NO_NETWORK);
+    expect("load square", netLoad(ctx, 4, square, 6), NET_OK);
+    expect("build square", netBuildMst(ctx), NET_OK);
+    expect("square cost", netMstCost(ctx, &total), NET_OK);
+    if (total != 6) {
+        printf("FAIL: square cost %lld, expected 6\n", total);
+        failures++;
+    }
+    expect("square parents", netParents(ctx, &parents), NET_OK);
+    expect("path 1 -> 0", netFindPath(ctx, 1, 0, path, 4, &length), NET_OK);
+    if (length != 4 || path[0] != 1 || path[1] != 2 || path[2] != 3 || path[3] != 0) {
+        printf("FAIL: path 1 -> 0 has %d nodes, expected 1 2 3 0\n", length);
+        failures++;
+    }
+    expect("path 2 -> 2", netFindPath(ctx, 2, 2, path, 4, &length), NET_OK);
+    if (length != 1 || path[0] != 2) {
+        printf("FAIL: path 2 -> 2 has %d nodes, expected 2\n", length);
+        failures++;
+    }
+    expect("short buffer", netFindPath(ctx, 1, 0, path, 2, &length), NET_ERROR_BUFFER_TOO_SMALL);
+    if (length != 4) {
+        printf("FAIL: short buffer reported %d nodes, expected 4\n", length);
+        failures++;
+    }
+    expect("node out of range", netFindPath(ctx, 0, 4, path, 4, &length), NET_ERROR_INVALID_INPUT);
+    expect("self loop", netLoad(ctx, 2, loop, 1), NET_ERROR_INVALID_INPUT);
+    expect("path after failed load", netFindPath(ctx, 0, 1, path, 4, &length), NET_ERROR_NO_NETWORK);
+
+    expect("load empty", netLoad(ctx, 0, NULL, 0), NET_OK);
+    expect("build empty", netBuildMst(ctx), NET_OK);
+    expect("empty cost", netMstCost(ctx, &total), NET_OK);
+    if (total != 0) {
+        printf("FAIL: empty cost %lld, expected 0\n", total);
+        failures++;
+    }
+
+    // A lone node is its own tree, so the path to itself is that node, as the program prints.
+    expect("load lone node", netLoad(ctx, 1, NULL, 0), NET_OK);
+    expect("build lone node", netBuildMst(ctx), NET_OK);
+    expect("path 0 -> 0", netFindPath(ctx, 0, 0, path, 4, &length), NET_OK);
+    if (length != 1 || path[0] != 0) {
+        printf("FAIL: path 0 -> 0 has %d nodes, expected 0\n", length);
+        failures++;
+    }
+
+    expect("load split", netLoad(ctx, 4, split, 2), NET_OK);
+    expect("build split", netBuildMst(ctx), NET_ERROR_NOT_CONNECTED);
+
+    netDestroy(ctx);
+
+    // A fresh context whose first network is empty must not touch unallocated buffers.
+    ctx = netCreate();
+    expect("first load empty", netLoad(ctx, 0, NULL, 0), NET_OK);
+    expect("first build empty", netBuildMst(ctx), NET_OK);
+    netDestroy(ctx);
+
+    if (failures == 0)
+        printf("ALL OK\n");
+    return failures == 0 ? 0 : 1;
+}